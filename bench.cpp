@@ -0,0 +1,392 @@
+// 로거 벤치마크: 호출 지연 분위수(p50/p99/p99.9)와 생산자 스레드 수별 처리량
+// 빌드: g++ -std=c++17 -O2 -pthread bench.cpp -o bench
+// 사용: ./bench [--quick] [--threads N] [--messages N] [--filter 문자열] [--csv | --json] [--out 파일]
+//   --threads   처리량 측정에 쓸 최대 생산자 스레드 수 (1, 2, 4, ... N, 기본값은 코어 수와 8 중 작은 값)
+//   --messages  스레드당 메시지 수 (기본 100000, --quick이면 20000)
+//   --filter    케이스 이름에 문자열이 들어간 것만 실행 (예: file/deferred, /t4)
+//   --csv/--json  기계가 읽는 형식으로 출력 (기본은 표), --out이 있으면 파일로 저장
+#include "logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // 콘솔 싱크 측정 중 std::cout을 버리는 버퍼 (터미널 속도가 섞이지 않도록)
+    class NullBuffer : public std::streambuf {
+    protected:
+        int_type overflow(int_type ch) override { return traits_type::not_eof(ch); }
+        std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+    };
+
+    enum class SinkKind { Null, File, Console };
+    enum class Mode { Queue, Buffered, Deferred, Sync };
+
+    const char* sink_name(SinkKind sink) {
+        switch (sink) {
+        case SinkKind::Null: return "null";
+        case SinkKind::File: return "file";
+        default: return "console";
+        }
+    }
+
+    const char* mode_name(Mode mode) {
+        switch (mode) {
+        case Mode::Queue: return "queue";
+        case Mode::Buffered: return "buffered";
+        case Mode::Deferred: return "deferred";
+        default: return "sync";
+        }
+    }
+
+    // 호출 한 번의 모양 (i는 메시지 번호)
+    struct Payload {
+        const char* name;
+        std::function<void(utils::Logger&, int)> call;
+    };
+
+    const std::string kPlayerName = "PlayerOne";
+    const std::string kLongText(400, 'x');                   // 인라인 공간을 넘는 메시지
+    const std::string kRuntimeFormat = "플레이어 정보: ID={}, 이름={}";  // 리터럴이 아니면 런타임 포맷 경로
+
+    std::vector<Payload> make_payloads() {
+        return {
+            { "args0", [](utils::Logger& logger, int) {
+                CPPLOG_LOG_TO(logger, utils::LogLevel::INFO, info, "서버 상태 점검 완료");
+            } },
+            { "args2", [](utils::Logger& logger, int i) {
+                CPPLOG_LOG_TO(logger, utils::LogLevel::INFO, info, "플레이어 정보: ID={}, 이름={}", i, kPlayerName);
+            } },
+            { "args6", [](utils::Logger& logger, int i) {
+                CPPLOG_LOG_TO(logger, utils::LogLevel::INFO, info, "플레이어 {} 위치: ({}, {}) 이름={} 활성={} 점수={}",
+                    i, 100.5f, 200.7f, kPlayerName, (i & 1) != 0, i * 3.14);
+            } },
+            { "long", [](utils::Logger& logger, int i) {
+                CPPLOG_LOG_TO(logger, utils::LogLevel::INFO, info, "요청 {} 본문: {}", i, kLongText);
+            } },
+            { "runtime2", [](utils::Logger& logger, int i) {
+                logger.info(kRuntimeFormat, i, kPlayerName);
+            } },
+        };
+    }
+
+    struct Case {
+        SinkKind sink;
+        Mode mode;
+        const Payload* payload;
+        int threads;
+
+        std::string name() const {
+            return std::string(sink_name(sink)) + "/" + mode_name(mode) + "/" + payload->name + "/t" + std::to_string(threads);
+        }
+    };
+
+    struct Result {
+        Case test;
+        uint64_t messages = 0;
+        double mean_ns = 0;
+        uint64_t p50_ns = 0;
+        uint64_t p99_ns = 0;
+        uint64_t p999_ns = 0;
+        uint64_t max_ns = 0;
+        double producer_rate = 0;     // 생산자 스레드가 호출을 끝낸 시점 기준 (메시지/초)
+        double sustained_rate = 0;    // flush()로 모든 싱크 출력이 끝난 시점 기준 (메시지/초)
+        uint64_t dropped = 0;
+    };
+
+    uint64_t percentile(const std::vector<uint64_t>& sorted, double fraction) {
+        if (sorted.empty()) return 0;
+        size_t rank = static_cast<size_t>(fraction * static_cast<double>(sorted.size()));
+        return sorted[(std::min)(rank, sorted.size() - 1)];
+    }
+
+    // 연속 두 번 읽은 시계 차이의 중앙값 (지연 값에 이만큼의 측정 비용이 포함된다)
+    uint64_t clock_overhead_ns() {
+        std::vector<uint64_t> samples(10000);
+        for (auto& sample : samples) {
+            auto start = Clock::now();
+            auto end = Clock::now();
+            sample = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+        std::sort(samples.begin(), samples.end());
+        return percentile(samples, 0.5);
+    }
+
+    Result run_case(const Case& test, int messages, const std::filesystem::path& file_path) {
+        NullBuffer null_buffer;
+        std::streambuf* saved_cout = nullptr;
+
+        Result result;
+        result.test = test;
+        result.messages = static_cast<uint64_t>(messages) * static_cast<uint64_t>(test.threads);
+
+        {
+            utils::Logger logger;
+            logger.set_max_queue_size(1 << 16);
+            logger.set_overflow_policy(utils::OverflowPolicy::Block);
+            logger.set_overflow_block_timeout(std::chrono::milliseconds(1000));
+
+            switch (test.sink) {
+            case SinkKind::Null:
+                logger.add_sink(std::make_unique<utils::NullSink>());
+                break;
+            case SinkKind::File:
+                logger.add_sink(std::make_unique<utils::FileSink>(file_path.string(), size_t(1) << 40, 1));
+                break;
+            case SinkKind::Console:
+                saved_cout = std::cout.rdbuf(&null_buffer);
+                logger.add_sink(std::make_unique<utils::ConsoleSink>(false));
+                break;
+            }
+
+            switch (test.mode) {
+            case Mode::Buffered: logger.set_thread_buffering(true); break;
+            case Mode::Deferred: logger.set_deferred_formatting(true); break;
+            case Mode::Sync: logger.set_synchronous(true); break;
+            default: break;
+            }
+
+            // 준비 운동: 스테이징/아레나/파일 버퍼를 채워 둔다
+            for (int i = 0; i < 1000; ++i) {
+                test.payload->call(logger, i);
+            }
+            logger.flush();
+            uint64_t dropped_before = logger.stats().dropped;
+
+            std::vector<std::vector<uint64_t>> samples(static_cast<size_t>(test.threads));
+            std::atomic<int> ready{ 0 };
+            std::atomic<bool> go{ false };
+            std::vector<std::thread> producers;
+
+            for (int t = 0; t < test.threads; ++t) {
+                producers.emplace_back([&, t] {
+                    auto& local = samples[static_cast<size_t>(t)];
+                    local.resize(static_cast<size_t>(messages));
+                    ready.fetch_add(1);
+                    while (!go.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+                    for (int i = 0; i < messages; ++i) {
+                        auto start = Clock::now();
+                        test.payload->call(logger, i);
+                        auto end = Clock::now();
+                        local[static_cast<size_t>(i)] = static_cast<uint64_t>(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+                    }
+                });
+            }
+
+            while (ready.load() < test.threads) {
+                std::this_thread::yield();
+            }
+            auto start = Clock::now();
+            go.store(true, std::memory_order_release);
+            for (auto& producer : producers) {
+                producer.join();
+            }
+            auto produced = Clock::now();
+            logger.flush();
+            auto done = Clock::now();
+
+            result.dropped = logger.stats().dropped - dropped_before;
+
+            std::vector<uint64_t> merged;
+            merged.reserve(static_cast<size_t>(result.messages));
+            for (auto& local : samples) {
+                merged.insert(merged.end(), local.begin(), local.end());
+            }
+            std::sort(merged.begin(), merged.end());
+
+            double total = static_cast<double>(result.messages);
+            result.mean_ns = std::accumulate(merged.begin(), merged.end(), 0.0) / total;
+            result.p50_ns = percentile(merged, 0.50);
+            result.p99_ns = percentile(merged, 0.99);
+            result.p999_ns = percentile(merged, 0.999);
+            result.max_ns = merged.empty() ? 0 : merged.back();
+            result.producer_rate = total / std::chrono::duration<double>(produced - start).count();
+            result.sustained_rate = total / std::chrono::duration<double>(done - start).count();
+        }
+
+        if (saved_cout) {
+            std::cout.rdbuf(saved_cout);
+        }
+        std::error_code ignored;
+        std::filesystem::remove(file_path, ignored);
+        return result;
+    }
+
+    struct Options {
+        int max_threads = (std::max)(1, (std::min)(8, static_cast<int>(std::thread::hardware_concurrency())));
+        int messages = 100000;
+        std::string filter;
+        std::string format = "text";
+        std::string out;
+    };
+
+    bool parse_options(int argc, char* argv[], Options& options) {
+        bool messages_set = false;
+        bool quick = false;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+
+            if (arg == "--quick") {
+                quick = true;
+            }
+            else if (arg == "--csv" || arg == "--json") {
+                options.format = arg.substr(2);
+            }
+            else if (arg == "--threads" || arg == "--messages" || arg == "--filter" || arg == "--out") {
+                const char* text = value();
+                if (!text) return false;
+                if (arg == "--threads") options.max_threads = (std::max)(1, std::atoi(text));
+                if (arg == "--messages") { options.messages = (std::max)(1, std::atoi(text)); messages_set = true; }
+                if (arg == "--filter") options.filter = text;
+                if (arg == "--out") options.out = text;
+            }
+            else {
+                return false;
+            }
+        }
+        if (quick) {
+            if (!messages_set) options.messages = 20000;
+            options.max_threads = (std::min)(options.max_threads, 2);
+        }
+        return true;
+    }
+
+    // 한 스레드에서 모든 싱크/모드/호출 모양 조합, 그리고 args2 호출로 스레드 수를 늘려 가며 측정
+    std::vector<Case> make_cases(const std::vector<Payload>& payloads, const Options& options) {
+        const SinkKind sinks[] = { SinkKind::Null, SinkKind::File, SinkKind::Console };
+        const Mode modes[] = { Mode::Queue, Mode::Buffered, Mode::Deferred, Mode::Sync };
+
+        std::vector<Case> cases;
+        for (SinkKind sink : sinks) {
+            for (Mode mode : modes) {
+                for (const auto& payload : payloads) {
+                    cases.push_back({ sink, mode, &payload, 1 });
+                }
+            }
+        }
+
+        const Payload* scaling = &payloads[1];
+        for (int threads = 2; threads <= options.max_threads; threads *= 2) {
+            for (SinkKind sink : { SinkKind::Null, SinkKind::File }) {
+                for (Mode mode : modes) {
+                    cases.push_back({ sink, mode, scaling, threads });
+                }
+            }
+        }
+        if (options.max_threads > 1 && (options.max_threads & (options.max_threads - 1)) != 0) {
+            for (SinkKind sink : { SinkKind::Null, SinkKind::File }) {
+                for (Mode mode : modes) {
+                    cases.push_back({ sink, mode, scaling, options.max_threads });
+                }
+            }
+        }
+
+        if (!options.filter.empty()) {
+            cases.erase(std::remove_if(cases.begin(), cases.end(),
+                [&](const Case& test) { return test.name().find(options.filter) == std::string::npos; }), cases.end());
+        }
+        return cases;
+    }
+
+    void write_text(std::ostream& os, const std::vector<Result>& results) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-34s %9s %8s %8s %9s %9s %12s %12s %8s\n",
+            "case", "mean(ns)", "p50", "p99", "p99.9", "max", "calls/s", "sustained/s", "dropped");
+        os << line;
+        for (const auto& r : results) {
+            std::snprintf(line, sizeof(line), "%-34s %9.1f %8llu %8llu %9llu %9llu %12.0f %12.0f %8llu\n",
+                r.test.name().c_str(), r.mean_ns,
+                static_cast<unsigned long long>(r.p50_ns), static_cast<unsigned long long>(r.p99_ns),
+                static_cast<unsigned long long>(r.p999_ns), static_cast<unsigned long long>(r.max_ns),
+                r.producer_rate, r.sustained_rate, static_cast<unsigned long long>(r.dropped));
+            os << line;
+        }
+    }
+
+    void write_csv(std::ostream& os, const std::vector<Result>& results) {
+        os << "sink,mode,payload,threads,messages,mean_ns,p50_ns,p99_ns,p999_ns,max_ns,calls_per_sec,sustained_per_sec,dropped\n";
+        for (const auto& r : results) {
+            os << sink_name(r.test.sink) << ',' << mode_name(r.test.mode) << ',' << r.test.payload->name << ','
+                << r.test.threads << ',' << r.messages << ',' << r.mean_ns << ',' << r.p50_ns << ',' << r.p99_ns << ','
+                << r.p999_ns << ',' << r.max_ns << ',' << static_cast<uint64_t>(r.producer_rate) << ','
+                << static_cast<uint64_t>(r.sustained_rate) << ',' << r.dropped << '\n';
+        }
+    }
+
+    void write_json(std::ostream& os, const std::vector<Result>& results, uint64_t clock_ns) {
+        auto now = std::chrono::system_clock::now();
+        os << "{\"timestamp\":\"" << utils::format_timestamp(now) << "\",\"hardware_threads\":"
+            << std::thread::hardware_concurrency() << ",\"clock_overhead_ns\":" << clock_ns << ",\"cases\":[";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            os << (i ? "," : "") << "\n  {\"sink\":\"" << sink_name(r.test.sink) << "\",\"mode\":\"" << mode_name(r.test.mode)
+                << "\",\"payload\":\"" << r.test.payload->name << "\",\"threads\":" << r.test.threads
+                << ",\"messages\":" << r.messages << ",\"mean_ns\":" << r.mean_ns << ",\"p50_ns\":" << r.p50_ns
+                << ",\"p99_ns\":" << r.p99_ns << ",\"p999_ns\":" << r.p999_ns << ",\"max_ns\":" << r.max_ns
+                << ",\"calls_per_sec\":" << static_cast<uint64_t>(r.producer_rate)
+                << ",\"sustained_per_sec\":" << static_cast<uint64_t>(r.sustained_rate)
+                << ",\"dropped\":" << r.dropped << "}";
+        }
+        os << "\n]}\n";
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s [--quick] [--threads N] [--messages N] [--filter text] [--csv | --json] [--out file]\n", argv[0]);
+        return 2;
+    }
+
+    auto payloads = make_payloads();
+    auto cases = make_cases(payloads, options);
+    auto file_path = std::filesystem::temp_directory_path() / "cpplog_bench.log";
+    uint64_t clock_ns = clock_overhead_ns();
+
+    // 진행 상황은 stderr로 (결과 출력과 섞이지 않도록)
+    std::vector<Result> results;
+    for (size_t i = 0; i < cases.size(); ++i) {
+        std::fprintf(stderr, "[%zu/%zu] %s\n", i + 1, cases.size(), cases[i].name().c_str());
+        results.push_back(run_case(cases[i], options.messages, file_path));
+    }
+
+    std::ofstream file;
+    if (!options.out.empty()) {
+        file.open(options.out);
+        if (!file) {
+            std::fprintf(stderr, "%s: cannot open\n", options.out.c_str());
+            return 1;
+        }
+    }
+    std::ostream& os = options.out.empty() ? std::cout : file;
+
+    if (options.format == "csv") {
+        write_csv(os, results);
+    }
+    else if (options.format == "json") {
+        write_json(os, results, clock_ns);
+    }
+    else {
+        os << "clock overhead (included in latencies): " << clock_ns << " ns, messages per thread: " << options.messages << "\n";
+        write_text(os, results);
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+// 공유 메모리 링(SharedMemorySink)으로 들어온 여러 프로세스의 로그를 파일 하나에 기록 (POSIX 전용)
+// 빌드: g++ -std=c++17 -O2 -pthread log_collector.cpp -o log_collector   (glibc 2.17 이전은 -lrt 추가)
+// 사용: ./log_collector [-p pattern] [-s max_size_mb] [-n max_files] [--json] [--remove] ring_name output_file
+//       SIGINT/SIGTERM으로 종료하면 남은 항목을 모두 기록하고, SIGHUP을 받으면 출력 파일을 다시 연다.
+#include "logger.hpp"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+namespace {
+    volatile std::sig_atomic_t g_stop = 0;
+
+    void on_stop(int) {
+        g_stop = 1;
+    }
+
+    int usage(const char* program) {
+        std::fprintf(stderr,
+            "usage: %s [-p pattern] [-s max_size_mb] [-n max_files] [--json] [--remove] ring_name output_file\n",
+            program);
+        return 2;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // 보낸 프로세스는 %k의 pid= / thread= 필드로 구분한다
+    std::string pattern = "[%Y-%m-%d %H:%M:%S.%e] [%l] %v%k";
+    size_t max_size = 10 * 1024 * 1024;
+    int max_files = 5;
+    bool json = false;
+    bool remove = false;
+
+    int i = 1;
+    for (; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-p" && i + 1 < argc) pattern = argv[++i];
+        else if (arg == "-s" && i + 1 < argc) max_size = std::strtoull(argv[++i], nullptr, 10) * 1024 * 1024;
+        else if (arg == "-n" && i + 1 < argc) max_files = std::atoi(argv[++i]);
+        else if (arg == "--json") json = true;
+        else if (arg == "--remove") remove = true;
+        else break;
+    }
+    if (argc - i != 2) {
+        return usage(argv[0]);
+    }
+    std::string ring_name = argv[i];
+    std::string output = argv[i + 1];
+
+    // 전역 인스턴스와 별도로 이 도구만의 Logger를 쓴다
+    utils::Logger logger;
+    if (json) {
+        logger.add_sink(std::make_unique<utils::JsonSink>(output, max_size, max_files));
+    }
+    else {
+        logger.add_sink(std::make_unique<utils::FileSink>(output, max_size, max_files, pattern));
+    }
+    // 링에서 꺼낸 항목을 이 스레드에서 바로 기록한다: 큐를 거치지 않으므로 수집기가 죽어도
+    // 링에서 꺼냈지만 아직 쓰지 못한 항목이 거의 없고, 밀리면 링이 대신 채워진다
+    logger.set_synchronous(true);
+    utils::Logger::reopen_on_signal();
+
+    std::unique_ptr<utils::SharedMemoryCollector> collector;
+    try {
+        collector = std::make_unique<utils::SharedMemoryCollector>(ring_name);
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    std::signal(SIGINT, on_stop);
+    std::signal(SIGTERM, on_stop);
+
+    // 비어 있으면 1ms까지 점점 길게 쉰다
+    auto idle = std::chrono::microseconds(0);
+    while (!g_stop) {
+        if (collector->poll(logger) > 0) {
+            idle = std::chrono::microseconds(0);
+            continue;
+        }
+        idle = (std::min)(idle + std::chrono::microseconds(50), std::chrono::microseconds(1000));
+        std::this_thread::sleep_for(idle);
+    }
+
+    while (collector->poll(logger) > 0) {
+    }
+    logger.flush();
+
+    std::fprintf(stderr, "%s: backlog=%llu dropped=%llu truncated=%llu abandoned=%llu stalled=%llu\n", ring_name.c_str(),
+        static_cast<unsigned long long>(collector->backlog()),
+        static_cast<unsigned long long>(collector->dropped()),
+        static_cast<unsigned long long>(collector->truncated()),
+        static_cast<unsigned long long>(collector->abandoned()),
+        static_cast<unsigned long long>(collector->stalled()));
+
+    collector.reset();
+    if (remove) {
+        utils::SharedMemoryCollector::remove(ring_name);
+    }
+    return 0;
+}
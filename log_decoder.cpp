@@ -0,0 +1,53 @@
+// BinaryFileSink 파일을 텍스트 로그로 변환
+// 빌드: g++ -std=c++17 -O2 -pthread log_decoder.cpp -o log_decoder
+// 사용: ./log_decoder [-p pattern] app.blog [app.blog.1 ...]   (기본 패턴은 FileSink와 같음)
+#include "logger.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    std::string pattern = utils::FileSink::kDefaultPattern;
+    int first_file = 1;
+    if (argc > 2 && std::string(argv[1]) == "-p") {
+        pattern = argv[2];
+        first_file = 3;
+    }
+
+    if (first_file >= argc) {
+        std::fprintf(stderr, "usage: %s [-p pattern] file...\n", argv[0]);
+        return 2;
+    }
+
+    utils::PatternFormatter formatter(pattern);
+    std::string line;
+    int status = 0;
+
+    for (int i = first_file; i < argc; ++i) {
+        std::ifstream input(argv[i], std::ios::binary);
+        if (!input) {
+            std::fprintf(stderr, "%s: cannot open\n", argv[i]);
+            status = 1;
+            continue;
+        }
+        std::string data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+        utils::BinaryLogReader reader(data);
+        utils::BinaryLogReader::Record record;
+        while (reader.next(record)) {
+            line.clear();
+            formatter.format(record.timestamp, record.level, record.thread_id, record.message, line);
+            line += '\n';
+            std::fwrite(line.data(), 1, line.size(), stdout);
+        }
+
+        // 비정상 종료로 잘린 마지막 항목은 그 앞까지 출력하고 알린다
+        if (!reader.error().empty()) {
+            std::fprintf(stderr, "%s: %s\n", argv[i], reader.error().c_str());
+            status = 1;
+        }
+    }
+
+    return status;
+}
@@ -6,14 +6,65 @@
 #include <vector>
 #include <thread>
 #include <mutex>
-#include <queue>
 #include <atomic>
 #include <condition_variable>
 #include <chrono>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <ctime>
 #include <filesystem>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <tuple>
+#include <functional>
+#include <deque>
+#include <unordered_map>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <charconv>
+#include <limits>
+#include <regex>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(CPPLOG_USE_ZSTD)
+#include <zstd.h>
+#endif
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <csignal>
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(_WIN32)
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
 
 namespace utils {
 
@@ -25,13 +76,255 @@ namespace utils {
 		FATAL = 4
 	};
 
-	struct LogEntry {
+	namespace detail {
+
+		// 인라인 공간을 넘는 메시지용 풀: 크기 등급별 free list에서 재사용하므로 정상 상태에서는 힙 할당이 없다
+		class MessageArena {
+		private:
+			static constexpr size_t kClassCount = 4;
+			static constexpr size_t kMinBlockSize = 512;
+			static constexpr size_t kMaxCachedBytes = 4 * 1024 * 1024;  // 등급별 보관 상한
+
+			struct FreeBlock {
+				FreeBlock* next;
+			};
+
+			struct SizeClass {
+				std::mutex mutex;
+				FreeBlock* head = nullptr;
+				size_t count = 0;
+			};
+
+			SizeClass classes_[kClassCount];
+
+			static constexpr size_t class_size(size_t index) {
+				return kMinBlockSize << (index * 2);  // 512, 2K, 8K, 32K
+			}
+
+		public:
+			// 프로그램 종료 시점까지 남은 로그가 반납할 수 있도록 해제하지 않는다
+			static MessageArena& instance() {
+				static MessageArena* arena = new MessageArena();
+				return *arena;
+			}
+
+			char* allocate(size_t size, uint32_t& capacity) {
+				for (size_t i = 0; i < kClassCount; ++i) {
+					if (size <= class_size(i)) {
+						capacity = static_cast<uint32_t>(class_size(i));
+						{
+							std::lock_guard<std::mutex> lock(classes_[i].mutex);
+							if (FreeBlock* block = classes_[i].head) {
+								classes_[i].head = block->next;
+								--classes_[i].count;
+								return reinterpret_cast<char*>(block);
+							}
+						}
+						return new char[capacity];
+					}
+				}
+
+				capacity = static_cast<uint32_t>(size);
+				return new char[capacity];
+			}
+
+			void deallocate(char* data, uint32_t capacity) {
+				for (size_t i = 0; i < kClassCount; ++i) {
+					if (capacity == class_size(i)) {
+						std::lock_guard<std::mutex> lock(classes_[i].mutex);
+						if (classes_[i].count < kMaxCachedBytes / class_size(i)) {
+							auto* block = reinterpret_cast<FreeBlock*>(data);
+							block->next = classes_[i].head;
+							classes_[i].head = block;
+							++classes_[i].count;
+							return;
+						}
+						break;
+					}
+				}
+				delete[] data;
+			}
+		};
+
+	} // namespace detail
+
+	// LogEntry 안에 들어가는 메시지 저장소
+	// 짧은 메시지는 인라인 버퍼에, 긴 메시지는 MessageArena 블록에 저장된다.
+	// 지연 포맷 인자는 인라인 버퍼 앞쪽에 놓이고, 텍스트는 그 뒤에 이어서 기록된다.
+	class LogMessage {
+	public:
+		static constexpr size_t kInlineCapacity = 184;
+
+		LogMessage() noexcept : size_(0), args_size_(0), capacity_(0), overflow_(nullptr) {}
+
+		LogMessage(const LogMessage& other) : LogMessage() {
+			copy_from(other);
+		}
+
+		LogMessage(LogMessage&& other) noexcept : LogMessage() {
+			move_from(other);
+		}
+
+		LogMessage& operator=(const LogMessage& other) {
+			if (this != &other) {
+				release();
+				copy_from(other);
+			}
+			return *this;
+		}
+
+		LogMessage& operator=(LogMessage&& other) noexcept {
+			if (this != &other) {
+				release();
+				move_from(other);
+			}
+			return *this;
+		}
+
+		LogMessage& operator=(std::string_view text) {
+			clear();
+			append(text);
+			return *this;
+		}
+
+		~LogMessage() {
+			release();
+		}
+
+		const char* data() const { return overflow_ ? overflow_ : inline_ + args_size_; }
+		size_t size() const { return size_; }
+		bool empty() const { return size_ == 0; }
+		std::string_view view() const { return std::string_view(data(), size_); }
+		std::string str() const { return std::string(data(), size_); }
+		operator std::string_view() const { return view(); }
+
+		void append(const char* text, size_t length) {
+			if (!overflow_) {
+				if (length <= kInlineCapacity - args_size_ - size_) {
+					std::memcpy(inline_ + args_size_ + size_, text, length);
+					size_ += static_cast<uint32_t>(length);
+					return;
+				}
+				grow(size_ + length);
+			}
+			else if (size_ + length > capacity_) {
+				grow(size_ + length);
+			}
+			std::memcpy(overflow_ + size_, text, length);
+			size_ += static_cast<uint32_t>(length);
+		}
+
+		void append(std::string_view text) {
+			append(text.data(), text.size());
+		}
+
+		void push_back(char c) {
+			append(&c, 1);
+		}
+
+		// 텍스트만 비움 (지연 포맷 인자는 유지)
+		void clear() {
+			if (overflow_) {
+				detail::MessageArena::instance().deallocate(overflow_, capacity_);
+				overflow_ = nullptr;
+				capacity_ = 0;
+			}
+			size_ = 0;
+		}
+
+		// 지연 포맷 인자 영역 확보 (텍스트가 비어 있을 때만 호출)
+		unsigned char* reserve_args(size_t length) {
+			args_size_ = static_cast<uint16_t>((std::min)(length, kInlineCapacity));
+			return reinterpret_cast<unsigned char*>(inline_);
+		}
+
+		const unsigned char* args() const { return reinterpret_cast<const unsigned char*>(inline_); }
+		size_t args_size() const { return args_size_; }
+
+		friend std::ostream& operator<<(std::ostream& os, const LogMessage& message) {
+			return os.write(message.data(), static_cast<std::streamsize>(message.size()));
+		}
+
+		friend bool operator==(const LogMessage& lhs, std::string_view rhs) { return lhs.view() == rhs; }
+		friend bool operator!=(const LogMessage& lhs, std::string_view rhs) { return lhs.view() != rhs; }
+
+	private:
+		char inline_[kInlineCapacity];
+		uint32_t size_;
+		uint16_t args_size_;
+		uint32_t capacity_;
+		char* overflow_;
+
+		void grow(size_t required) {
+			uint32_t new_capacity = 0;
+			char* block = detail::MessageArena::instance().allocate(
+				(std::max)(required, static_cast<size_t>(capacity_) * 2), new_capacity);
+			std::memcpy(block, data(), size_);
+			if (overflow_) {
+				detail::MessageArena::instance().deallocate(overflow_, capacity_);
+			}
+			overflow_ = block;
+			capacity_ = new_capacity;
+		}
+
+		void release() {
+			clear();
+			args_size_ = 0;
+		}
+
+		void copy_from(const LogMessage& other) {
+			args_size_ = other.args_size_;
+			std::memcpy(inline_, other.inline_, args_size_);
+			append(other.data(), other.size_);
+		}
+
+		void move_from(LogMessage& other) {
+			args_size_ = other.args_size_;
+			size_ = other.size_;
+			if (other.overflow_) {
+				std::memcpy(inline_, other.inline_, args_size_);
+				overflow_ = other.overflow_;
+				capacity_ = other.capacity_;
+				other.overflow_ = nullptr;
+				other.capacity_ = 0;
+			}
+			else {
+				std::memcpy(inline_, other.inline_, args_size_ + size_);
+			}
+			other.size_ = 0;
+			other.args_size_ = 0;
+		}
+	};
+
+	// 캐시 라인 정렬된 고정 크기(256바이트) 로그 항목
+	struct alignas(64) LogEntry {
+		static constexpr size_t kDeferredArgsCapacity = LogMessage::kInlineCapacity;
+
 		std::chrono::system_clock::time_point timestamp;
 		LogLevel level;
+
+		// kv() 구조화 필드: 인자 영역 끝의 field_bytes 바이트에 field_count개가 인코딩된다
+		uint16_t field_count = 0;
+		uint16_t field_bytes = 0;
+
 		std::thread::id thread_id;
-		std::string message;
+
+		// 지연 포맷 모드: 정적 포맷 문자열과 인자 타입 (워커가 message 텍스트를 채운 뒤에도 유지)
+		const char* format = nullptr;
+		const char* arg_types = nullptr;
+
+		// 이름 있는 로거(NamedLogger)로 기록한 경우 그 이름, 기본 로거는 nullptr
+		const char* logger_name = nullptr;
+
+		LogMessage message;
+
+		// 지연 포맷 인자 바이트 (구조화 필드 제외)
+		size_t format_args_size() const { return message.args_size() - field_bytes; }
+		const unsigned char* fields_data() const { return message.args() + format_args_size(); }
 	};
 
+	static_assert(sizeof(LogEntry) <= 256, "LogEntry must fit in a 256-byte slot");
+
 	inline std::string level_to_string(LogLevel level) {
 		switch (level) {
 		case LogLevel::DEBUG: return "DEBUG";
@@ -54,399 +347,6502 @@ namespace utils {
 		}
 	}
 
-	inline std::string format_timestamp(const std::chrono::system_clock::time_point& tp) {
-		auto time_t = std::chrono::system_clock::to_time_t(tp);
-		auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-			tp.time_since_epoch()) % 1000;
+	namespace detail {
+
+		inline void write_digits(char* out, unsigned value, int width) {
+			for (int i = width - 1; i >= 0; --i) {
+				out[i] = static_cast<char>('0' + value % 10);
+				value /= 10;
+			}
+		}
 
-		std::tm time_info;
+		inline std::tm to_local_time(std::time_t time) {
+			std::tm time_info;
 #ifdef _WIN32
-		if (localtime_s(&time_info, &time_t) != 0) {
+			if (localtime_s(&time_info, &time) != 0) {
 #else
-		if (localtime_r(&time_t, &time_info) == nullptr) {
+			if (localtime_r(&time, &time_info) == nullptr) {
 #endif
-			throw std::runtime_error("Failed to convert time");
+				throw std::runtime_error("Failed to convert time");
+			}
+			return time_info;
 		}
 
-		std::ostringstream oss;
-		oss << std::put_time(&time_info, "%Y-%m-%d %H:%M:%S");
-		oss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-		return oss.str();
+		// "YYYY-MM-DD HH:MM:SS.mmm" 포맷 캐시
+		// 초가 바뀔 때만 localtime을 호출하고, 그 사이에는 밀리초 세 자리만 다시 쓴다.
+		class TimestampCache {
+		public:
+			static constexpr size_t kLength = 23;
+
+			std::string_view format(const std::chrono::system_clock::time_point& tp) {
+				auto since_epoch = tp.time_since_epoch();
+				auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+				if (seconds > since_epoch) {
+					seconds -= std::chrono::seconds(1);  // 음수 시각은 내림
+				}
+				auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch - seconds).count();
+
+				if (!valid_ || seconds.count() != cached_seconds_) {
+					refresh(static_cast<std::time_t>(seconds.count()));
+					cached_seconds_ = seconds.count();
+					valid_ = true;
+				}
+
+				write_digits(buffer_ + 20, static_cast<unsigned>(ms), 3);
+				return std::string_view(buffer_, kLength);
+			}
+
+		private:
+			std::chrono::seconds::rep cached_seconds_ = 0;
+			bool valid_ = false;
+			char buffer_[kLength + 1] = "0000-00-00 00:00:00.000";
+
+			void refresh(std::time_t time) {
+				std::tm time_info = to_local_time(time);
+				write_digits(buffer_, static_cast<unsigned>(time_info.tm_year + 1900), 4);
+				write_digits(buffer_ + 5, static_cast<unsigned>(time_info.tm_mon + 1), 2);
+				write_digits(buffer_ + 8, static_cast<unsigned>(time_info.tm_mday), 2);
+				write_digits(buffer_ + 11, static_cast<unsigned>(time_info.tm_hour), 2);
+				write_digits(buffer_ + 14, static_cast<unsigned>(time_info.tm_min), 2);
+				write_digits(buffer_ + 17, static_cast<unsigned>(time_info.tm_sec), 2);
+			}
+		};
+
+		// 스레드 ID 텍스트 캐시 (싱크마다 하나, 워커 스레드만 사용)
+		class ThreadIdCache {
+		private:
+			static constexpr size_t kCapacity = 64;
+
+			std::vector<std::pair<std::thread::id, std::string>> items_;
+			size_t next_slot_ = 0;
+
+		public:
+			std::string_view text(std::thread::id id) {
+				for (const auto& cached : items_) {
+					if (cached.first == id) {
+						return cached.second;
+					}
+				}
+
+				std::ostringstream oss;
+				oss << id;
+				if (items_.size() < kCapacity) {
+					items_.emplace_back(id, oss.str());
+					return items_.back().second;
+				}
+
+				auto& slot = items_[next_slot_];
+				next_slot_ = (next_slot_ + 1) % kCapacity;
+				slot = { id, oss.str() };
+				return slot.second;
+			}
+
+			void clear() {
+				items_.clear();
+				next_slot_ = 0;
+			}
+		};
+
+	} // namespace detail
+
+	inline std::string format_timestamp(const std::chrono::system_clock::time_point& tp) {
+		static thread_local detail::TimestampCache cache;
+		return std::string(cache.format(tp));
 	}
 
-	class LogSink {
-	public:
-		virtual ~LogSink() = default;
-		virtual void write(const LogEntry& entry) = 0;
-		virtual void flush() = 0;
+	namespace detail {
+
+		// 숫자를 텍스트로 바꾸는 공용 경로 (ostream의 locale/num_put을 거치지 않는다)
+		// 실수는 값을 그대로 되읽을 수 있는 가장 짧은 표기를 쓴다 (float은 float 기준).
+		constexpr size_t kNumberTextSize = 32;
+
+		template<typename T>
+		size_t number_to_chars(char* buffer, T value) {
+			if constexpr (std::is_integral_v<T>) {
+				return static_cast<size_t>(std::to_chars(buffer, buffer + kNumberTextSize, value).ptr - buffer);
+			}
+			else {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+				return static_cast<size_t>(std::to_chars(buffer, buffer + kNumberTextSize, value).ptr - buffer);
+#else
+				// 부동소수점 to_chars가 없는 표준 라이브러리: 짧은 자릿수로 되읽히는지 확인하고 안 되면 최대 자릿수
+				int length = std::snprintf(buffer, kNumberTextSize, "%.*g", std::numeric_limits<T>::digits10, static_cast<double>(value));
+				if (static_cast<T>(std::strtod(buffer, nullptr)) != value && value == value) {
+					length = std::snprintf(buffer, kNumberTextSize, "%.*g", std::numeric_limits<T>::max_digits10, static_cast<double>(value));
+				}
+				return static_cast<size_t>((std::max)(length, 0));
+#endif
+			}
+		}
+
+		template<typename T>
+		void append_number(std::string& out, T value) {
+			char buffer[kNumberTextSize];
+			out.append(buffer, number_to_chars(buffer, value));
+		}
+
+		inline void append_hex(std::string& out, uint64_t value) {
+			char buffer[kNumberTextSize];
+			out.append(buffer, static_cast<size_t>(std::to_chars(buffer, buffer + kNumberTextSize, value, 16).ptr - buffer));
+		}
+
+		template<typename T>
+		void write_number(std::ostream& os, T value) {
+			char buffer[kNumberTextSize];
+			os.write(buffer, static_cast<std::streamsize>(number_to_chars(buffer, value)));
+		}
+
+		// operator<< 대신 직접 기록하는 인자 타입 (bool은 ostream 기본값과 같게 1/0)
+		template<typename T>
+		constexpr bool is_plain_number_v = (std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>
+			&& !std::is_same_v<T, signed char> && !std::is_same_v<T, unsigned char>
+			&& !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>)
+			|| std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+		template<typename T>
+		constexpr bool has_fast_text_v = is_plain_number_v<T> || std::is_same_v<T, bool> || std::is_same_v<T, char>
+			|| std::is_same_v<T, const char*> || std::is_same_v<T, char*>
+			|| std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+		// 사용자 타입의 operator<<가 std::hex 같은 상태를 남겼다면 이후 인자도 ostream으로 기록한다
+		inline bool plain_stream(const std::ostream& os) {
+			return os.flags() == (std::ios_base::dec | std::ios_base::skipws) && os.width() == 0;
+		}
+
+		template<typename T>
+		void write_fast_text(std::ostream& os, const T& value) {
+			if constexpr (is_plain_number_v<T>) {
+				write_number(os, value);
+			}
+			else if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, char>) {
+				char c = std::is_same_v<T, bool> ? (value ? '1' : '0') : static_cast<char>(value);
+				os.write(&c, 1);
+			}
+			else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>) {
+				std::string_view text = value ? std::string_view(value) : std::string_view("(null)");
+				os.write(text.data(), static_cast<std::streamsize>(text.size()));
+			}
+			else {
+				os.write(value.data(), static_cast<std::streamsize>(value.size()));
+			}
+		}
+
+	} // namespace detail
+
+	namespace detail {
+
+		// 지연 포맷용 인자 인코딩: 타입 코드 한 글자 + 고정 크기 값 (문자열은 u32 길이 + 바이트)
+		//   i: int64, u: uint64, f: float, d: double, b: bool, c: char, s: 문자열, p: 포인터
+		template<typename T, typename = void>
+		struct DeferredArg {
+			static constexpr bool supported = false;
+		};
+
+		template<typename T>
+		struct FixedDeferredArg {
+			static constexpr bool supported = true;
+			static size_t size(T) { return sizeof(T); }
+			static void encode(unsigned char* out, T value) { std::memcpy(out, &value, sizeof(T)); }
+		};
+
+		template<typename T>
+		struct DeferredArg<T, std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>
+			&& !std::is_same_v<T, char> && !std::is_same_v<T, signed char>>> {
+			static constexpr bool supported = true;
+			static constexpr char code = 'i';
+			static size_t size(T) { return sizeof(int64_t); }
+			static void encode(unsigned char* out, T value) { FixedDeferredArg<int64_t>::encode(out, value); }
+		};
+
+		template<typename T>
+		struct DeferredArg<T, std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T>
+			&& !std::is_same_v<T, bool> && !std::is_same_v<T, unsigned char>>> {
+			static constexpr bool supported = true;
+			static constexpr char code = 'u';
+			static size_t size(T) { return sizeof(uint64_t); }
+			static void encode(unsigned char* out, T value) { FixedDeferredArg<uint64_t>::encode(out, value); }
+		};
+
+		// float은 float 그대로 남겨야 가장 짧은 표기가 즉시 포맷과 같아진다
+		template<>
+		struct DeferredArg<float> : FixedDeferredArg<float> {
+			static constexpr char code = 'f';
+		};
+
+		template<>
+		struct DeferredArg<double> : FixedDeferredArg<double> {
+			static constexpr char code = 'd';
+		};
+
+		template<>
+		struct DeferredArg<bool> : FixedDeferredArg<bool> {
+			static constexpr char code = 'b';
+		};
+
+		template<typename T>
+		struct DeferredArg<T, std::enable_if_t<std::is_same_v<T, char> || std::is_same_v<T, signed char>
+			|| std::is_same_v<T, unsigned char>>> {
+			static constexpr bool supported = true;
+			static constexpr char code = 'c';
+			static size_t size(T) { return 1; }
+			static void encode(unsigned char* out, T value) { *out = static_cast<unsigned char>(value); }
+		};
+
+		struct StringDeferredArg {
+			static constexpr bool supported = true;
+			static constexpr char code = 's';
+			static size_t size(std::string_view value) { return sizeof(uint32_t) + value.size(); }
+			static void encode(unsigned char* out, std::string_view value) {
+				auto length = static_cast<uint32_t>(value.size());
+				std::memcpy(out, &length, sizeof(length));
+				std::memcpy(out + sizeof(length), value.data(), value.size());
+			}
+		};
+
+		template<> struct DeferredArg<std::string> : StringDeferredArg {};
+		template<> struct DeferredArg<std::string_view> : StringDeferredArg {};
+
+		template<typename T>
+		struct DeferredArg<T, std::enable_if_t<std::is_same_v<T, const char*> || std::is_same_v<T, char*>>>
+			: StringDeferredArg {
+			static std::string_view view(const char* value) { return value ? value : "(null)"; }
+			static size_t size(const char* value) { return StringDeferredArg::size(view(value)); }
+			static void encode(unsigned char* out, const char* value) { StringDeferredArg::encode(out, view(value)); }
+		};
+
+		template<typename T>
+		struct DeferredArg<T, std::enable_if_t<std::is_pointer_v<T>
+			&& !std::is_same_v<T, const char*> && !std::is_same_v<T, char*>>> {
+			static constexpr bool supported = true;
+			static constexpr char code = 'p';
+			static size_t size(T) { return sizeof(uint64_t); }
+			static void encode(unsigned char* out, T value) {
+				FixedDeferredArg<uint64_t>::encode(out, reinterpret_cast<uintptr_t>(value));
+			}
+		};
+
+		template<typename... Args>
+		constexpr bool all_deferrable_v = (DeferredArg<std::decay_t<Args>>::supported && ...);
+
+		// 인자 타입 시그니처 문자열 (예: "ids")
+		template<typename... Args>
+		struct DeferredSignature {
+			static constexpr char value[] = { DeferredArg<std::decay_t<Args>>::code..., '\0' };
+		};
+
+		template<typename T>
+		size_t deferred_size(const T& value) {
+			return DeferredArg<std::decay_t<T>>::size(value);
+		}
+
+		template<typename T>
+		unsigned char* deferred_encode(unsigned char* out, const T& value) {
+			DeferredArg<std::decay_t<T>>::encode(out, value);
+			return out + DeferredArg<std::decay_t<T>>::size(value);
+		}
+
+		// kv()가 만드는 구조화 필드 (같은 식 안에서만 쓰이므로 값은 참조로 들고 있다)
+		// 지연 포맷이 지원하지 않는 타입은 kv() 호출 시점에 operator<<로 문자열로 바꿔 둔다.
+		template<typename T>
+		struct KeyValue {
+			static constexpr bool stored_as_text = !DeferredArg<std::decay_t<T>>::supported;
+
+			std::string_view key;
+			std::conditional_t<stored_as_text, std::string, const T&> value;
+		};
+
+		template<typename T>
+		struct is_key_value : std::false_type {};
+
+		template<typename T>
+		struct is_key_value<KeyValue<T>> : std::true_type {};
+
+		template<typename T>
+		constexpr bool is_key_value_v = is_key_value<std::decay_t<T>>::value;
+
+		// 앞쪽 N개는 포맷 인자, 나머지는 모두 kv() 필드인지
+		template<size_t N, typename Tuple, size_t... I>
+		constexpr bool fields_trail(std::index_sequence<I...>) {
+			return ((is_key_value_v<std::tuple_element_t<I, Tuple>> == (I >= N)) && ...);
+		}
+
+		// 필드 인코딩: u8 키 길이 + 키 + 타입 코드 + 값 (지연 포맷 인자와 같은 형식)
+		constexpr size_t kMaxFieldKey = 255;
+
+		template<typename T>
+		size_t field_size(const KeyValue<T>& field) {
+			size_t key = (std::min)(field.key.size(), kMaxFieldKey);
+			if constexpr (KeyValue<T>::stored_as_text) {
+				return 2 + key + StringDeferredArg::size(field.value);
+			}
+			else {
+				return 2 + key + deferred_size(field.value);
+			}
+		}
+
+		template<typename T>
+		unsigned char* encode_field(unsigned char* out, const KeyValue<T>& field) {
+			size_t key = (std::min)(field.key.size(), kMaxFieldKey);
+			*out++ = static_cast<unsigned char>(key);
+			std::memcpy(out, field.key.data(), key);
+			out += key;
+			if constexpr (KeyValue<T>::stored_as_text) {
+				*out++ = static_cast<unsigned char>(StringDeferredArg::code);
+				StringDeferredArg::encode(out, field.value);
+				return out + StringDeferredArg::size(field.value);
+			}
+			else {
+				*out++ = static_cast<unsigned char>(DeferredArg<std::decay_t<T>>::code);
+				return deferred_encode(out, field.value);
+			}
+		}
+
+		template<typename... Fields>
+		size_t fields_size(const std::tuple<Fields...>& fields) {
+			return std::apply([](const auto&... field) { return (static_cast<size_t>(0) + ... + field_size(field)); }, fields);
+		}
+
+		template<typename... Fields>
+		unsigned char* encode_fields(unsigned char* out, const std::tuple<Fields...>& fields) {
+			std::apply([&out](const auto&... field) { ((out = encode_field(out, field)), ...); }, fields);
+			return out;
+		}
+
+		template<typename T>
+		T read_packed(const unsigned char* data) {
+			T value;
+			std::memcpy(&value, data, sizeof(T));
+			return value;
+		}
+
+		// 인자 하나를 디코딩해서 출력하고 소비한 바이트 수를 반환 (잘못된 데이터면 0)
+		inline size_t append_packed_arg(std::ostream& os, char type, const unsigned char* data, size_t size) {
+			switch (type) {
+			case 'i':
+				if (size < sizeof(int64_t)) return 0;
+				write_number(os, read_packed<int64_t>(data));
+				return sizeof(int64_t);
+			case 'u':
+				if (size < sizeof(uint64_t)) return 0;
+				write_number(os, read_packed<uint64_t>(data));
+				return sizeof(uint64_t);
+			case 'f':
+				if (size < sizeof(float)) return 0;
+				write_number(os, read_packed<float>(data));
+				return sizeof(float);
+			case 'd':
+				if (size < sizeof(double)) return 0;
+				write_number(os, read_packed<double>(data));
+				return sizeof(double);
+			case 'b':
+				if (size < 1) return 0;
+				write_fast_text(os, data[0] != 0);
+				return 1;
+			case 'c':
+				if (size < 1) return 0;
+				write_fast_text(os, static_cast<char>(data[0]));
+				return 1;
+			case 's': {
+				if (size < sizeof(uint32_t)) return 0;
+				auto length = read_packed<uint32_t>(data);
+				if (size - sizeof(uint32_t) < length) return 0;
+				os.write(reinterpret_cast<const char*>(data + sizeof(uint32_t)), length);
+				return sizeof(uint32_t) + length;
+			}
+			case 'p':
+				if (size < sizeof(uint64_t)) return 0;
+				os << reinterpret_cast<const void*>(static_cast<uintptr_t>(read_packed<uint64_t>(data)));
+				return sizeof(uint64_t);
+			default:
+				return 0;
+			}
+		}
+
+		// 포맷 문자열의 {}를 패킹된 인자로 치환 (Logger::format_recursive와 같은 규칙)
+		inline void format_packed(std::ostream& os, std::string_view format, const char* types,
+			const unsigned char* data, size_t size) {
+			for (const char* type = types; type && *type; ++type) {
+				size_t pos = format.find("{}");
+				if (pos == std::string_view::npos) {
+					break;  // 남은 인자들은 무시 (포맷 문자열에 {} 부족)
+				}
+				os.write(format.data(), pos);
+				size_t used = append_packed_arg(os, *type, data, size);
+				if (used == 0) {
+					os << "[FORMAT_ERROR]";
+					size = 0;
+				}
+				data += used;
+				size -= used;
+				format.remove_prefix(pos + 2);
+			}
+			os.write(format.data(), format.size());
+		}
+
+	} // namespace detail
+
+	// 구조화 필드: logger.info("login", kv("user", name), kv("ip", ip))
+	// 필드는 포맷 인자 뒤에 오며, 문자열로 바꾸지 않고 타입 그대로 항목에 담긴다 (JsonSink, %k 패턴 플래그).
+	template<typename T>
+	detail::KeyValue<T> kv(std::string_view key, const T& value) {
+		if constexpr (detail::KeyValue<T>::stored_as_text) {
+			std::ostringstream oss;
+			oss << value;
+			return { key, oss.str() };
+		}
+		else {
+			return { key, value };
+		}
+	}
+
+	// 항목에서 읽은 구조화 필드 하나 (type은 i/u/d/b/c/s/p, 포인터 값은 u에 들어간다)
+	struct LogField {
+		std::string_view key;
+		char type = 0;
+		int64_t i = 0;
+		uint64_t u = 0;
+		double d = 0;
+		bool b = false;
+		char c = 0;
+		std::string_view s;
 	};
 
-	class ConsoleSink : public LogSink {
-	private:
-		bool use_colors_;
+	// entry의 구조화 필드를 기록 순서대로 fn(const LogField&)에 넘긴다
+	template<typename Fn>
+	void for_each_field(const LogEntry& entry, Fn&& fn) {
+		const unsigned char* data = entry.fields_data();
+		size_t size = entry.field_bytes;
+
+		for (uint16_t n = 0; n < entry.field_count && size >= 2; ++n) {
+			LogField field;
+			size_t key = data[0];
+			if (size < 2 + key) return;
+			field.key = std::string_view(reinterpret_cast<const char*>(data + 1), key);
+			field.type = static_cast<char>(data[1 + key]);
+			data += 2 + key;
+			size -= 2 + key;
+
+			size_t used = 0;
+			switch (field.type) {
+			case 'i': used = sizeof(int64_t); if (size >= used) field.i = detail::read_packed<int64_t>(data); break;
+			case 'u':
+			case 'p': used = sizeof(uint64_t); if (size >= used) field.u = detail::read_packed<uint64_t>(data); break;
+			case 'f': used = sizeof(float); if (size >= used) field.d = detail::read_packed<float>(data); break;
+			case 'd': used = sizeof(double); if (size >= used) field.d = detail::read_packed<double>(data); break;
+			case 'b': used = 1; if (size >= used) field.b = data[0] != 0; break;
+			case 'c': used = 1; if (size >= used) field.c = static_cast<char>(data[0]); break;
+			case 's': {
+				if (size < sizeof(uint32_t)) return;
+				auto length = detail::read_packed<uint32_t>(data);
+				used = sizeof(uint32_t) + length;
+				if (size >= used) field.s = std::string_view(reinterpret_cast<const char*>(data + sizeof(uint32_t)), length);
+				break;
+			}
+			default:
+				return;
+			}
+			if (size < used) return;
+
+			fn(static_cast<const LogField&>(field));
+			data += used;
+			size -= used;
+		}
+	}
+
+	namespace detail {
+
+		// %k 패턴 플래그와 필드가 인자 영역에 들어가지 않을 때 쓰는 " key=value" 표기
+		inline void append_field_text(std::string& out, const LogField& field) {
+			out += ' ';
+			out += field.key;
+			out += '=';
+			switch (field.type) {
+			case 'i': append_number(out, field.i); break;
+			case 'u': append_number(out, field.u); break;
+			case 'p': out += "0x"; append_hex(out, field.u); break;
+			case 'f': append_number(out, static_cast<float>(field.d)); break;
+			case 'd': append_number(out, field.d); break;
+			case 'b': out += field.b ? "true" : "false"; break;
+			case 'c': out += field.c; break;
+			case 's': out += field.s; break;
+			default: break;
+			}
+		}
+
+		// 컴파일 타임 포맷 문자열 파싱 (LOG_* 매크로가 CPPLOG_FORMAT으로 생성)
+		constexpr size_t constexpr_strlen(const char* str) {
+			size_t length = 0;
+			while (str[length] != '\0') {
+				++length;
+			}
+			return length;
+		}
+
+		constexpr size_t count_placeholders(const char* str) {
+			size_t count = 0;
+			for (size_t i = 0; str[i] != '\0'; ++i) {
+				if (str[i] == '{' && str[i + 1] == '}') {
+					++count;
+					++i;
+				}
+			}
+			return count;
+		}
+
+		template<size_t N>
+		constexpr std::array<size_t, N + 1> placeholder_offsets(const char* str) {
+			std::array<size_t, N + 1> offsets{};
+			size_t index = 0;
+			size_t i = 0;
+			for (; str[i] != '\0'; ++i) {
+				if (str[i] == '{' && str[i + 1] == '}') {
+					offsets[index++] = i;
+					++i;
+				}
+			}
+			offsets[N] = i;  // 마지막 항목은 문자열 끝
+			return offsets;
+		}
+
+		// Source::value()가 반환하는 리터럴의 {} 위치를 컴파일 타임에 계산
+		template<typename Source>
+		struct CompiledFormat {
+			static constexpr const char* value() { return Source::value(); }
+			static constexpr size_t length = constexpr_strlen(Source::value());
+			static constexpr size_t arg_count = count_placeholders(Source::value());
+			static constexpr std::array<size_t, arg_count + 1> offsets = placeholder_offsets<arg_count>(Source::value());
+
+			// i번째 {} 앞의 리터럴 구간 (i == arg_count면 마지막 꼬리)
+			static constexpr size_t segment_begin(size_t i) { return i == 0 ? 0 : offsets[i - 1] + 2; }
+			static constexpr size_t segment_length(size_t i) { return offsets[i] - segment_begin(i); }
+		};
+
+		template<typename T>
+		struct is_compiled_format : std::false_type {};
+
+		template<typename Source>
+		struct is_compiled_format<CompiledFormat<Source>> : std::true_type {};
+
+		// LogMessage에 바로 기록하는 streambuf (중간 std::string 없음)
+		class MessageStreamBuf : public std::streambuf {
+		private:
+			LogMessage* target_ = nullptr;
+
+		public:
+			void reset(LogMessage* target) { target_ = target; }
+
+		protected:
+			int_type overflow(int_type ch) override {
+				if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+					target_->push_back(traits_type::to_char_type(ch));
+				}
+				return traits_type::not_eof(ch);
+			}
+
+			std::streamsize xsputn(const char* text, std::streamsize count) override {
+				target_->append(text, static_cast<size_t>(count));
+				return count;
+			}
+		};
+
+		// 스레드별로 재사용하는 ostream을 LogMessage에 연결 (operator<< 안에서 다시 로그를 남기면 임시 스트림 사용)
+		class MessageStream {
+		private:
+			struct Cached {
+				MessageStreamBuf buffer;
+				std::ostream stream{ &buffer };
+				bool busy = false;
+			};
+
+			Cached* cached_;
+			std::unique_ptr<Cached> nested_;
+
+			static Cached& thread_cached() {
+				static thread_local Cached cached;
+				return cached;
+			}
+
+		public:
+			explicit MessageStream(LogMessage& target) : cached_(&thread_cached()) {
+				if (cached_->busy) {
+					nested_ = std::make_unique<Cached>();
+					cached_ = nested_.get();
+				}
+				cached_->busy = true;
+				cached_->buffer.reset(&target);
+				cached_->stream.clear();
+				cached_->stream.flags(std::ios_base::dec | std::ios_base::skipws);
+				cached_->stream.precision(6);
+				cached_->stream.width(0);
+				cached_->stream.fill(' ');
+			}
+
+			~MessageStream() {
+				cached_->busy = false;
+				cached_->buffer.reset(nullptr);
+			}
+
+			MessageStream(const MessageStream&) = delete;
+			MessageStream& operator=(const MessageStream&) = delete;
+
+			std::ostream& get() { return cached_->stream; }
+		};
+
+		inline void cpu_relax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+			_mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+			__builtin_ia32_pause();
+#elif defined(__aarch64__)
+			asm volatile("yield");
+#else
+			std::this_thread::yield();
+#endif
+		}
+
+		// 슬롯별 시퀀스 번호를 사용하는 고정 크기 링 버퍼 (Vyukov bounded queue)
+		// 생산자는 tail_ CAS 한 번으로 슬롯을 확보하고, 소비자는 잠금 없이 꺼낸다.
+		// 가득 찬 큐에서 생산자가 가장 오래된 항목을 버릴 수 있도록 pop도 다중 스레드에 안전하다.
+		template<typename T>
+		class RingBuffer {
+		private:
+			struct alignas(64) Slot {
+				std::atomic<size_t> sequence;
+				T value;
+			};
+
+			std::unique_ptr<Slot[]> slots_;
+			size_t mask_;
+			alignas(64) std::atomic<size_t> head_;
+			alignas(64) std::atomic<size_t> tail_;
+
+			static size_t round_up_pow2(size_t value) {
+				size_t result = 2;
+				while (result < value) {
+					result <<= 1;
+				}
+				return result;
+			}
+
+		public:
+			explicit RingBuffer(size_t capacity)
+				: slots_(new Slot[round_up_pow2(capacity)]),
+				mask_(round_up_pow2(capacity) - 1),
+				head_(0),
+				tail_(0) {
+				for (size_t i = 0; i <= mask_; ++i) {
+					slots_[i].sequence.store(i, std::memory_order_relaxed);
+				}
+			}
+
+			RingBuffer(const RingBuffer&) = delete;
+			RingBuffer& operator=(const RingBuffer&) = delete;
+
+			template<typename U>
+			bool try_push(U&& value) {
+				Slot* slot;
+				size_t pos = tail_.load(std::memory_order_relaxed);
+				for (;;) {
+					slot = &slots_[pos & mask_];
+					size_t seq = slot->sequence.load(std::memory_order_acquire);
+					auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+					if (diff == 0) {
+						if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+							break;
+						}
+					}
+					else if (diff < 0) {
+						return false;  // 가득 참
+					}
+					else {
+						pos = tail_.load(std::memory_order_relaxed);
+					}
+				}
+
+				slot->value = std::forward<U>(value);
+				slot->sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+
+			bool try_pop(T& out) {
+				Slot* slot;
+				size_t pos = head_.load(std::memory_order_relaxed);
+				for (;;) {
+					slot = &slots_[pos & mask_];
+					size_t seq = slot->sequence.load(std::memory_order_acquire);
+					auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+					if (diff == 0) {
+						if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+							break;
+						}
+					}
+					else if (diff < 0) {
+						return false;  // 비어 있음 (또는 기록 중인 슬롯)
+					}
+					else {
+						pos = head_.load(std::memory_order_relaxed);
+					}
+				}
+
+				out = std::move(slot->value);
+				slot->sequence.store(pos + mask_ + 1, std::memory_order_release);
+				return true;
+			}
+
+			bool empty_approx() const {
+				return head_.load(std::memory_order_acquire) >= tail_.load(std::memory_order_acquire);
+			}
+
+			size_t size_approx() const {
+				size_t tail = tail_.load(std::memory_order_acquire);
+				size_t head = head_.load(std::memory_order_acquire);
+				return tail > head ? tail - head : 0;
+			}
+
+			size_t capacity() const {
+				return mask_ + 1;
+			}
+		};
+
+	} // namespace detail
+
+	// 기본 워커가 큐가 빌 때 기다리는 방식
+	enum class IdleStrategy {
+		Adaptive,      // 스핀 -> yield -> 조건 변수 (기본값)
+		Block,         // 바로 조건 변수에서 대기 (CPU 사용 최소, 깨우는 데 수 us)
+		Yield,         // yield 반복 (코어 하나를 계속 점유)
+		BusySpin,      // pause 명령 반복 (깨우기 지연 최소, 코어 하나를 전부 사용)
+		SleepBackoff   // 1us부터 두 배씩 늘려 최대 1ms까지 sleep (생산자가 깨우지 않음)
+	};
+
+	// 워커 스레드(기본 워커와 싱크 그룹 워커) 스케줄링 설정
+	// CPU 고정과 우선순위는 Linux에서만 적용되고, 다른 플랫폼에서는 무시된다.
+	struct WorkerOptions {
+		std::vector<int> cpus;                          // 고정할 CPU 번호 (비어 있으면 바꾸지 않음)
+		int nice = 0;                                   // 0이 아니면 스레드 nice 값 (-20 ~ 19, 음수는 권한 필요)
+		bool idle_priority = false;                     // SCHED_IDLE: 다른 스레드가 놀 때만 실행
+		IdleStrategy idle = IdleStrategy::Adaptive;     // 기본 워커만 적용
+	};
+
+	namespace detail {
+
+		// 호출한 스레드에 WorkerOptions의 CPU 고정과 우선순위를 적용 (실패하면 이유를 반환)
+		inline std::string configure_current_thread(const WorkerOptions& options) {
+			std::string error;
+#if defined(__linux__)
+			if (!options.cpus.empty()) {
+				cpu_set_t set;
+				CPU_ZERO(&set);
+				for (int cpu : options.cpus) {
+					if (cpu >= 0 && cpu < CPU_SETSIZE) {
+						CPU_SET(cpu, &set);
+					}
+				}
+				int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+				if (result != 0) {
+					error += "affinity: ";
+					error += std::strerror(result);
+				}
+			}
+
+			// SCHED_IDLE는 우선순위 값 0만 허용한다 (끄면 SCHED_OTHER로 되돌린다)
+			sched_param param{};
+			int policy = 0;
+			if (pthread_getschedparam(pthread_self(), &policy, &param) == 0
+				&& (options.idle_priority || policy == SCHED_IDLE)) {
+				param.sched_priority = 0;
+				int result = pthread_setschedparam(pthread_self(), options.idle_priority ? SCHED_IDLE : SCHED_OTHER, &param);
+				if (result != 0) {
+					error += error.empty() ? "" : ", ";
+					error += "scheduler: ";
+					error += std::strerror(result);
+				}
+			}
+
+			if (options.nice != 0) {
+				// Linux의 nice 값은 스레드(tid) 단위다
+				errno = 0;
+				if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), options.nice) != 0) {
+					error += error.empty() ? "" : ", ";
+					error += "nice: ";
+					error += std::strerror(errno);
+				}
+			}
+#else
+			(void)options;
+#endif
+			return error;
+		}
+
+		// 소비자 스레드용 대기 (IdleStrategy::Adaptive: 스핀 -> yield -> 조건 변수 파킹)
+		// 생산자는 소비자가 실제로 잠들어 있을 때만 notify 비용을 지불한다.
+		class IdleWaiter {
+		private:
+			static constexpr int kMinSpins = 16;
+			static constexpr int kMaxSpins = 4096;
+			static constexpr int kYields = 16;
+
+			std::mutex mutex_;
+			std::condition_variable condition_;
+			std::atomic<bool> parked_;
+			std::atomic<IdleStrategy> strategy_;
+			int spin_budget_;
+
+			// 파킹하지 않는 방식: ready()나 timeout까지 pause()를 반복
+			template<typename Predicate, typename Pause>
+			static void poll(Predicate& ready, std::chrono::milliseconds timeout, Pause&& pause) {
+				auto deadline = std::chrono::steady_clock::now() + timeout;
+				while (!ready() && std::chrono::steady_clock::now() < deadline) {
+					pause();
+				}
+			}
+
+		public:
+			IdleWaiter() : parked_(false), strategy_(IdleStrategy::Adaptive), spin_budget_(kMinSpins * 4) {}
+
+			void set_strategy(IdleStrategy strategy) {
+				strategy_.store(strategy, std::memory_order_relaxed);
+				notify_all();
+			}
+
+			// 생산자 측: 항목을 게시한 뒤 호출
+			void notify() {
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (parked_.load(std::memory_order_relaxed)) {
+					std::lock_guard<std::mutex> lock(mutex_);
+					condition_.notify_one();
+				}
+			}
+
+			// 종료 등 상태 변경 시 무조건 깨움
+			void notify_all() {
+				std::lock_guard<std::mutex> lock(mutex_);
+				condition_.notify_all();
+			}
+
+			// 소비자 측: ready()가 true가 되거나 timeout이 지날 때까지 대기
+			template<typename Predicate>
+			void wait(Predicate ready, std::chrono::milliseconds timeout) {
+				switch (strategy_.load(std::memory_order_relaxed)) {
+				case IdleStrategy::Block:
+					park(ready, timeout);
+					return;
+				case IdleStrategy::Yield:
+					poll(ready, timeout, [] { std::this_thread::yield(); });
+					return;
+				case IdleStrategy::BusySpin:
+					poll(ready, timeout, [] { cpu_relax(); });
+					return;
+				case IdleStrategy::SleepBackoff: {
+					auto delay = std::chrono::microseconds(1);
+					poll(ready, timeout, [&delay] {
+						std::this_thread::sleep_for(delay);
+						delay = (std::min)(delay * 2, std::chrono::microseconds(1000));
+						});
+					return;
+				}
+				default:
+					break;
+				}
+
+				for (int i = 0; i < spin_budget_; ++i) {
+					if (ready()) {
+						// 스핀으로 잡았으면 다음에는 조금 더 오래 스핀
+						spin_budget_ = (std::min)(spin_budget_ * 2, kMaxSpins);
+						return;
+					}
+					cpu_relax();
+				}
+				for (int i = 0; i < kYields; ++i) {
+					if (ready()) return;
+					std::this_thread::yield();
+				}
+
+				spin_budget_ = (std::max)(spin_budget_ / 2, kMinSpins);
+				park(ready, timeout);
+			}
+
+		private:
+			template<typename Predicate>
+			void park(Predicate& ready, std::chrono::milliseconds timeout) {
+				std::unique_lock<std::mutex> lock(mutex_);
+				parked_.store(true, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				condition_.wait_for(lock, timeout, ready);
+				parked_.store(false, std::memory_order_relaxed);
+			}
+		};
+
+		// 스레드별 스테이징 모드에서 워커로 한 번에 넘기는 로그 묶음
+		struct StagedChunk {
+			std::vector<LogEntry> entries;
+			StagedChunk* next = nullptr;
+		};
+
+		// (스레드, 로거) 쌍마다 하나씩 존재하는 스테이징 버퍼
+		// mutex는 소유 스레드와 워커의 시간 초과 회수 사이에서만 경합한다.
+		struct ThreadStage {
+			std::mutex mutex;
+			StagedChunk* chunk = nullptr;
+			std::chrono::system_clock::time_point first_timestamp;
+			void* owner = nullptr;      // 로거 종료 시 nullptr로 분리됨
+			std::atomic<bool> retired{ false };  // 소유 스레드 종료됨
+
+			~ThreadStage() {
+				delete chunk;
+			}
+		};
+
+	} // namespace detail
+
+	// Logger::stats()의 싱크별 항목
+	struct SinkStats {
+		size_t index = 0;           // 같은 워커 그룹 안에서 add_sink 순서
+		int worker_group = 0;       // 0이면 기본 워커
+		uint64_t entries = 0;
+		uint64_t writes = 0;        // write_batch 호출 수
+		uint64_t write_ns = 0;
+		uint64_t flushes = 0;
+		uint64_t flush_ns = 0;
+		uint64_t errors = 0;        // write/flush에서 던진 예외 수
+
+		// 싱크가 LogSink::collect_stats로 채우는 값
+		uint64_t bytes_sent = 0;
+		uint64_t dropped = 0;       // 싱크 자체 버퍼가 가득 차는 등으로 버린 항목
+	};
+
+	class LogSink {
+	public:
+		virtual ~LogSink() = default;
+		virtual void write(const LogEntry& entry) = 0;
+		virtual void flush() = 0;
+
+		// 워커가 모은 배치를 한 번에 전달 (기본 구현은 항목마다 write 호출)
+		virtual void write_batch(const LogEntry* entries, size_t count) {
+			for (size_t i = 0; i < count; ++i) {
+				write(entries[i]);
+			}
+		}
+
+		// entry.message 텍스트를 읽는 싱크인지 (모든 싱크가 false면 워커가 지연 포맷 항목을 텍스트로 만들지 않는다)
+		virtual bool uses_message_text() const {
+			return true;
+		}
+
+		// 싱크 고유 카운터를 Logger::stats()에 채운다 (워커가 아닌 스레드에서 호출되므로 원자 변수로 읽을 것)
+		virtual void collect_stats(SinkStats&) const {}
+
+		// Logger::reopen_sinks / 재열기 신호: 출력 파일을 같은 경로로 다시 연다 (워커 스레드에서 flush 직후 호출)
+		virtual void reopen() {}
+	};
+
+	// 싱크별 플러시 정책: 켜진 조건 중 하나라도 만족하면 워커가 flush()를 호출한다
+	// 기본값은 WARN 이상이 기록되었을 때와 1초마다이며, manual()은 Logger::flush() 호출 시에만 플러시한다.
+	struct FlushPolicy {
+		bool level_trigger = true;                          // min_level 이상이 기록되면 즉시
+		LogLevel min_level = LogLevel::WARN;
+		size_t max_bytes = 0;                               // 마지막 플러시 이후 메시지 바이트 (0이면 사용 안 함)
+		std::chrono::milliseconds interval{ 1000 };         // 워커 타이머 주기 (0이면 사용 안 함)
+
+		static FlushPolicy manual() {
+			FlushPolicy policy;
+			policy.level_trigger = false;
+			policy.interval = std::chrono::milliseconds(0);
+			return policy;
+		}
+
+		static FlushPolicy on_level(LogLevel level) {
+			FlushPolicy policy = manual();
+			policy.level_trigger = true;
+			policy.min_level = level;
+			return policy;
+		}
+
+		static FlushPolicy every_bytes(size_t bytes) {
+			FlushPolicy policy = manual();
+			policy.max_bytes = bytes;
+			return policy;
+		}
+
+		static FlushPolicy every(std::chrono::milliseconds interval) {
+			FlushPolicy policy = manual();
+			policy.interval = interval;
+			return policy;
+		}
+	};
+
+	struct SinkOptions {
+		FlushPolicy flush;
+
+		// 0이면 기본 워커가 출력하고, 1 이상이면 같은 번호의 싱크끼리 전용 워커 스레드를 가진다
+		// (느린 싱크가 다른 싱크를 막지 않도록 분리할 때 사용)
+		int worker_group = 0;
+
+		// 필터: 모두 통과한 항목만 이 싱크의 write_batch로 전달된다 (싱크가 포맷하기 전에 워커가 검사)
+		LogLevel min_level = LogLevel::DEBUG;
+		std::vector<std::string> loggers;       // 이름 있는 로거와 그 하위 로거만 ("" 은 기본 로거, 비어 있으면 전부)
+		std::string message_regex;              // 메시지 텍스트에 regex_search (비어 있으면 사용 안 함)
+		std::function<bool(const LogEntry&)> filter;
+	};
+
+	// 패턴 문자열을 한 번 컴파일해서 단계 목록으로 만들고, 로그 한 줄을 재사용 버퍼에 이어 붙인다
+	//   %Y %m %d %H %M %S : 연-월-일 시:분:초    %e : 밀리초 (3자리)
+	//   %l : 레벨 ("INFO ")    %L : 짧은 레벨 ("I")    %t : 스레드 ID    %v : 메시지
+	//   %^ ... %$ : 색상 구간    %% : '%' 문자
+	class PatternFormatter {
+	private:
+		enum class StepKind {
+			Literal,
+			Year, Month, Day, Hour, Minute, Second, Millisecond,
+			Level, ShortLevel, ThreadId, LoggerName, Message, Fields,
+			ColorBegin, ColorEnd
+		};
+
+		struct Step {
+			StepKind kind;
+			std::string literal;
+		};
+
+		std::string pattern_;
+		std::vector<Step> steps_;
+		detail::TimestampCache timestamp_cache_;
+		detail::ThreadIdCache thread_ids_;
+
+		void compile() {
+			steps_.clear();
+			std::string literal;
+
+			auto flush_literal = [&] {
+				if (!literal.empty()) {
+					steps_.push_back({ StepKind::Literal, literal });
+					literal.clear();
+				}
+			};
+
+			for (size_t i = 0; i < pattern_.size(); ++i) {
+				if (pattern_[i] != '%' || i + 1 == pattern_.size()) {
+					literal += pattern_[i];
+					continue;
+				}
+
+				StepKind kind;
+				switch (pattern_[++i]) {
+				case 'Y': kind = StepKind::Year; break;
+				case 'm': kind = StepKind::Month; break;
+				case 'd': kind = StepKind::Day; break;
+				case 'H': kind = StepKind::Hour; break;
+				case 'M': kind = StepKind::Minute; break;
+				case 'S': kind = StepKind::Second; break;
+				case 'e': kind = StepKind::Millisecond; break;
+				case 'l': kind = StepKind::Level; break;
+				case 'L': kind = StepKind::ShortLevel; break;
+				case 't': kind = StepKind::ThreadId; break;
+				case 'n': kind = StepKind::LoggerName; break;
+				case 'v': kind = StepKind::Message; break;
+				case 'k': kind = StepKind::Fields; break;
+				case '^': kind = StepKind::ColorBegin; break;
+				case '$': kind = StepKind::ColorEnd; break;
+				case '%':
+					literal += '%';
+					continue;
+				default:
+					// 알 수 없는 플래그는 그대로 출력
+					literal += '%';
+					literal += pattern_[i];
+					continue;
+				}
+
+				flush_literal();
+				steps_.push_back({ kind, std::string() });
+			}
+			flush_literal();
+		}
+
+		static std::string_view level_name(LogLevel level) {
+			switch (level) {
+			case LogLevel::DEBUG: return "DEBUG";
+			case LogLevel::INFO:  return "INFO ";
+			case LogLevel::WARN:  return "WARN ";
+			case LogLevel::ERROR: return "ERROR";
+			case LogLevel::FATAL: return "FATAL";
+			default: return "UNKNOWN";
+			}
+		}
+
+		static std::string_view short_level_name(LogLevel level) {
+			switch (level) {
+			case LogLevel::DEBUG: return "D";
+			case LogLevel::INFO:  return "I";
+			case LogLevel::WARN:  return "W";
+			case LogLevel::ERROR: return "E";
+			case LogLevel::FATAL: return "F";
+			default: return "?";
+			}
+		}
+
+	public:
+		explicit PatternFormatter(const std::string& pattern) : pattern_(pattern) {
+			compile();
+		}
+
+		PatternFormatter(const PatternFormatter& other) : pattern_(other.pattern_) {
+			compile();
+		}
+
+		PatternFormatter& operator=(const PatternFormatter& other) {
+			if (this != &other) {
+				pattern_ = other.pattern_;
+				thread_ids_.clear();
+				compile();
+			}
+			return *this;
+		}
+
+		const std::string& pattern() const {
+			return pattern_;
+		}
+
+		// entry 한 줄을 out 뒤에 붙임 (개행 없음)
+		void format(const LogEntry& entry, std::string& out,
+			std::string_view color_begin = {}, std::string_view color_end = {}) {
+			format_fields(entry.timestamp, entry.level, [&] { return thread_ids_.text(entry.thread_id); },
+				entry.logger_name ? std::string_view(entry.logger_name) : std::string_view(),
+				entry.message.view(), &entry, out, color_begin, color_end);
+		}
+
+		// LogEntry 없이 필드를 직접 받아 한 줄을 붙임 (바이너리 로그 디코더 등)
+		void format(std::chrono::system_clock::time_point timestamp, LogLevel level, std::string_view thread_id,
+			std::string_view message, std::string& out,
+			std::string_view color_begin = {}, std::string_view color_end = {}) {
+			format_fields(timestamp, level, [thread_id] { return thread_id; }, {}, message, nullptr, out, color_begin, color_end);
+		}
+
+	private:
+		// thread_text는 %t가 있을 때만 호출된다 (entry는 %k용, 필드로 직접 받은 경우 nullptr)
+		template<typename ThreadText>
+		void format_fields(std::chrono::system_clock::time_point tp, LogLevel level, ThreadText&& thread_text,
+			std::string_view logger_name, std::string_view message, const LogEntry* entry, std::string& out, std::string_view color_begin, std::string_view color_end) {
+			std::string_view timestamp;
+			for (const auto& step : steps_) {
+				if (step.kind >= StepKind::Year && step.kind <= StepKind::Millisecond && timestamp.empty()) {
+					timestamp = timestamp_cache_.format(tp);
+				}
+
+				switch (step.kind) {
+				case StepKind::Literal:     out += step.literal; break;
+				case StepKind::Year:        out.append(timestamp.data(), 4); break;
+				case StepKind::Month:       out.append(timestamp.data() + 5, 2); break;
+				case StepKind::Day:         out.append(timestamp.data() + 8, 2); break;
+				case StepKind::Hour:        out.append(timestamp.data() + 11, 2); break;
+				case StepKind::Minute:      out.append(timestamp.data() + 14, 2); break;
+				case StepKind::Second:      out.append(timestamp.data() + 17, 2); break;
+				case StepKind::Millisecond: out.append(timestamp.data() + 20, 3); break;
+				case StepKind::Level:       out += level_name(level); break;
+				case StepKind::ShortLevel:  out += short_level_name(level); break;
+				case StepKind::ThreadId:    out += thread_text(); break;
+				case StepKind::LoggerName:  out += logger_name; break;
+				case StepKind::Message:     out.append(message.data(), message.size()); break;
+				case StepKind::Fields:
+					if (entry && entry->field_count > 0) {
+						for_each_field(*entry, [&out](const LogField& field) { detail::append_field_text(out, field); });
+					}
+					break;
+				case StepKind::ColorBegin:  out += color_begin; break;
+				case StepKind::ColorEnd:    out += color_end; break;
+				}
+			}
+		}
+	};
+
+	// 패턴 포맷터와 재사용 줄 버퍼를 가진 싱크의 공통 부분
+	class FormattedSink : public LogSink {
+	protected:
+		PatternFormatter formatter_;
+		std::string line_buffer_;
+
+		explicit FormattedSink(const std::string& pattern) : formatter_(pattern) {
+			line_buffer_.reserve(512);
+		}
+
+	public:
+		// 워커가 쓰는 중에 바꾸지 않도록 add_sink 전에 호출
+		void set_pattern(const std::string& pattern) {
+			formatter_ = PatternFormatter(pattern);
+		}
+
+		const std::string& pattern() const {
+			return formatter_.pattern();
+		}
+	};
+
+	class ConsoleSink : public FormattedSink {
+	private:
+		bool use_colors_;
+
+	public:
+		static constexpr const char* kDefaultPattern = "%^[%Y-%m-%d %H:%M:%S.%e] %l [%t] %v%k%$";
+
+		explicit ConsoleSink(bool use_colors = true, const std::string& pattern = kDefaultPattern)
+			: FormattedSink(pattern), use_colors_(use_colors) {}
+
+		void write(const LogEntry& entry) override {
+			std::string_view color_code = use_colors_ ? get_color_code(entry.level) : "";
+			std::string_view reset_code = use_colors_ ? get_reset_code() : "";
+
+			line_buffer_.clear();
+			formatter_.format(entry, line_buffer_, color_code, reset_code);
+
+			line_buffer_ += '\n';
+
+			// 줄마다 플러시하지 않음 (플러시 시점은 FlushPolicy가 결정)
+			std::cout.write(line_buffer_.data(), static_cast<std::streamsize>(line_buffer_.size()));
+		}
+
+		// 배치 전체를 한 버퍼에 포맷해서 한 번에 출력
+		void write_batch(const LogEntry* entries, size_t count) override {
+			line_buffer_.clear();
+			for (size_t i = 0; i < count; ++i) {
+				std::string_view color_code = use_colors_ ? get_color_code(entries[i].level) : "";
+				std::string_view reset_code = use_colors_ ? get_reset_code() : "";
+				formatter_.format(entries[i], line_buffer_, color_code, reset_code);
+				line_buffer_ += '\n';
+			}
+
+			std::cout.write(line_buffer_.data(), static_cast<std::streamsize>(line_buffer_.size()));
+		}
+
+		void flush() override {
+			std::cout.flush();
+		}
+
+	private:
+		inline std::string_view get_color_code(LogLevel level) const {
+			switch (level) {
+			case LogLevel::DEBUG: return "\033[36m";    // Cyan
+			case LogLevel::INFO:  return "\033[32m";    // Green
+			case LogLevel::WARN:  return "\033[33m";    // Yellow
+			case LogLevel::ERROR: return "\033[31m";    // Red
+			case LogLevel::FATAL: return "\033[35m";    // Magenta
+			default: return "";
+			}
+		}
+
+		inline std::string_view get_reset_code() const {
+			return "\033[0m";
+		}
+	};
+
+	// 아무것도 쓰지 않고 항목 수와 메시지 바이트만 센다 (싱크 비용을 뺀 로거 자체 측정용)
+	// count_text가 false면 메시지 텍스트를 요구하지 않아 지연 포맷 항목은 포맷되지 않는다 (바이트는 0으로 남음).
+	class NullSink : public LogSink {
+	private:
+		bool count_text_;
+		std::atomic<uint64_t> entries_{ 0 };
+		std::atomic<uint64_t> bytes_{ 0 };
+
+	public:
+		explicit NullSink(bool count_text = true) : count_text_(count_text) {}
+
+		void write(const LogEntry& entry) override {
+			write_batch(&entry, 1);
+		}
+
+		void write_batch(const LogEntry* entries, size_t count) override {
+			uint64_t bytes = 0;
+			if (count_text_) {
+				for (size_t i = 0; i < count; ++i) {
+					bytes += entries[i].message.size() + 1;
+				}
+			}
+			entries_.store(entries_.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+			bytes_.store(bytes_.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+		}
+
+		void flush() override {}
+
+		bool uses_message_text() const override {
+			return count_text_;
+		}
+
+		void collect_stats(SinkStats& stats) const override {
+			stats.bytes_sent = bytes();
+		}
+
+		uint64_t entries() const {
+			return entries_.load(std::memory_order_relaxed);
+		}
+
+		// 개행을 포함한 메시지 바이트 (패턴 접두어 제외)
+		uint64_t bytes() const {
+			return bytes_.load(std::memory_order_relaxed);
+		}
+	};
+
+	// 최근 capacity줄을 포맷된 텍스트로 메모리에 보관 (디버그 엔드포인트나 크래시 리포트에 붙일 최근 로그)
+	// 가득 차면 가장 오래된 줄을 덮어쓴다. lines()는 다른 스레드에서 호출해도 된다.
+	class RingBufferSink : public FormattedSink {
+	private:
+		mutable std::mutex mutex_;
+		std::vector<std::string> lines_;
+		size_t capacity_;
+		size_t next_ = 0;
+		size_t size_ = 0;
+
+	public:
+		static constexpr const char* kDefaultPattern = "[%Y-%m-%d %H:%M:%S.%e] %l [%t] %v%k";
+
+		explicit RingBufferSink(size_t capacity = 1024, const std::string& pattern = kDefaultPattern)
+			: FormattedSink(pattern), lines_((std::max)(capacity, static_cast<size_t>(1))), capacity_(lines_.size()) {}
+
+		void write(const LogEntry& entry) override {
+			write_batch(&entry, 1);
+		}
+
+		// 락 밖에서 포맷하고, 락 안에서는 보관 중인 문자열 버퍼와 교환만 한다 (다음 덮어쓰기에서 그 버퍼를 재사용)
+		void write_batch(const LogEntry* entries, size_t count) override {
+			size_t first = count > capacity_ ? count - capacity_ : 0;
+			for (size_t i = first; i < count; ++i) {
+				line_buffer_.clear();
+				formatter_.format(entries[i], line_buffer_);
+
+				std::lock_guard<std::mutex> lock(mutex_);
+				lines_[next_].swap(line_buffer_);
+				next_ = (next_ + 1) % capacity_;
+				size_ = (std::min)(size_ + 1, capacity_);
+			}
+		}
+
+		void flush() override {}
+
+		// 오래된 줄부터 (개행 없음)
+		std::vector<std::string> lines() const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			std::vector<std::string> result;
+			result.reserve(size_);
+			for (size_t i = 0; i < size_; ++i) {
+				result.push_back(lines_[(next_ + capacity_ - size_ + i) % capacity_]);
+			}
+			return result;
+		}
+
+		// 줄마다 개행을 붙여 한 문자열로
+		std::string text() const {
+			std::string result;
+			for (const auto& line : lines()) {
+				result += line;
+				result += '\n';
+			}
+			return result;
+		}
+
+		size_t size() const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			return size_;
+		}
+
+		size_t capacity() const {
+			return capacity_;
+		}
+
+		void clear() {
+			std::lock_guard<std::mutex> lock(mutex_);
+			next_ = 0;
+			size_ = 0;
+		}
+	};
+
+	namespace detail {
+
+		// filename → filename.1 → ... → filename.max_files 순서로 이름을 민다 (가장 오래된 파일은 삭제)
+		// suffix가 있으면 현재 파일은 filename + suffix, 아카이브는 filename.N + suffix
+		inline void rotate_archives(const std::string& filename, int max_files, const std::string& suffix = "") {
+			for (int i = max_files - 1; i > 0; --i) {
+				std::string old_name = filename + "." + std::to_string(i) + suffix;
+				std::string new_name = filename + "." + std::to_string(i + 1) + suffix;
+
+				if (std::filesystem::exists(old_name)) {
+					if (i == max_files - 1) {
+						std::filesystem::remove(new_name);  // 오래된 파일 삭제
+					}
+					std::filesystem::rename(old_name, new_name);
+				}
+			}
+
+			// 현재 파일을 .1로 이름 변경
+			if (std::filesystem::exists(filename + suffix)) {
+				std::filesystem::rename(filename + suffix, filename + ".1" + suffix);
+			}
+		}
+
+		// 파일 시스템 작업을 로거 워커 밖에서 순서대로 처리하는 백그라운드 스레드
+		// 소멸 시 남은 작업을 모두 처리한 뒤 종료한다.
+		class Housekeeper {
+		public:
+			Housekeeper() : stop_(false), thread_(&Housekeeper::run, this) {}
+
+			~Housekeeper() {
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					stop_ = true;
+				}
+				cv_.notify_one();
+				thread_.join();
+			}
+
+			Housekeeper(const Housekeeper&) = delete;
+			Housekeeper& operator=(const Housekeeper&) = delete;
+
+			void post(std::function<void()> task) {
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					tasks_.push_back(std::move(task));
+				}
+				cv_.notify_one();
+			}
+
+			// 앞서 넣은 작업이 모두 끝날 때까지 대기
+			void drain() {
+				std::mutex done_mutex;
+				std::condition_variable done_cv;
+				bool done = false;
+				post([&] {
+					std::lock_guard<std::mutex> lock(done_mutex);
+					done = true;
+					done_cv.notify_one();
+				});
+				std::unique_lock<std::mutex> lock(done_mutex);
+				done_cv.wait(lock, [&] { return done; });
+			}
+
+		private:
+			void run() {
+				for (;;) {
+					std::function<void()> task;
+					{
+						std::unique_lock<std::mutex> lock(mutex_);
+						cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+						if (tasks_.empty()) return;
+						task = std::move(tasks_.front());
+						tasks_.pop_front();
+					}
+
+					try {
+						task();
+					}
+					catch (const std::exception& e) {
+						std::cerr << "Logger housekeeping error: " << e.what() << std::endl;
+					}
+				}
+			}
+
+			std::mutex mutex_;
+			std::condition_variable cv_;
+			std::deque<std::function<void()>> tasks_;
+			bool stop_;
+			std::thread thread_;
+		};
+
+		// 크기 기준 로테이션용 출력 파일 (현재 파일 <base><suffix>, 아카이브 <base>.N<suffix>)
+		// POSIX에서는 다음 파일(<base><suffix>.next)을 Housekeeper가 미리 열어 두고, rotate()는 스트림만 바꾼다.
+		// 이름 변경(아카이브 밀기)과 아카이브 훅은 백그라운드 스레드에서 실행되며, 다음 파일이 아직 준비되지 않았으면
+		// rotate()가 false를 반환하고 호출자는 현재 파일에 계속 기록한다.
+		// Windows는 열린 파일의 이름을 바꿀 수 없으므로 동기식으로 로테이션한다.
+		class RotatingFile {
+		private:
+			std::string base_;
+			std::string suffix_;
+			int max_files_;
+			std::ios::openmode mode_;
+			std::ofstream file_;
+			size_t initial_size_;
+
+			// 비동기 로테이션 상태
+			std::function<void(const std::string&)> archive_hook_;
+			std::mutex next_mutex_;
+			std::unique_ptr<std::ofstream> next_file_;
+			std::atomic<bool> next_ready_;
+			std::atomic<bool> next_failed_;
+			std::unique_ptr<Housekeeper> housekeeper_;
+
+		public:
+			// append가 false면 기존 내용이 있는 파일을 먼저 아카이브로 밀고 새 파일에서 시작
+			RotatingFile(const std::string& base, int max_files, const std::string& suffix = "",
+				std::ios::openmode mode = std::ios::openmode(), bool append = true)
+				: base_(base), suffix_(suffix), max_files_(max_files), mode_(mode), initial_size_(0),
+				next_ready_(false), next_failed_(false) {
+
+				// 디렉터리 생성
+				std::filesystem::path file_path(path());
+				if (file_path.has_parent_path()) {
+					std::filesystem::create_directories(file_path.parent_path());
+				}
+
+				// 이전 실행이 로테이션 도중 끝났다면 기록이 남은 .next를 현재 파일로 옮겨 마무리
+				std::error_code ec;
+				if (std::filesystem::file_size(next_path(), ec) > 0 && !ec) {
+					rotate_archives(base_, max_files_, suffix_);
+					std::filesystem::rename(next_path(), path());
+				}
+
+				if (!append && std::filesystem::file_size(path(), ec) > 0 && !ec) {
+					rotate_archives(base_, max_files_, suffix_);
+				}
+
+				file_.open(path(), std::ios::app | mode_);
+				if (file_.is_open()) {
+					// 기존 파일 크기 확인
+					file_.seekp(0, std::ios::end);
+					initial_size_ = static_cast<size_t>(file_.tellp());
+				}
+
+#if !defined(_WIN32)
+				housekeeper_ = std::make_unique<Housekeeper>();
+				housekeeper_->post([this] { prepare_next(); });
+#endif
+			}
+
+			~RotatingFile() {
+				housekeeper_.reset();  // 진행 중인 로테이션 마무리
+
+				if (file_.is_open()) {
+					file_.close();
+				}
+
+				// 쓰지 않은 다음 파일 정리
+				if (next_file_) {
+					next_file_->close();
+					std::error_code ec;
+					std::filesystem::remove(next_path(), ec);
+				}
+			}
+
+			RotatingFile(const RotatingFile&) = delete;
+			RotatingFile& operator=(const RotatingFile&) = delete;
+
+			std::ofstream& stream() {
+				return file_;
+			}
+
+			bool is_open() const {
+				return file_.is_open();
+			}
+
+			// 열 때 이미 있던 내용의 크기 (이어 쓰기)
+			size_t initial_size() const {
+				return initial_size_;
+			}
+
+			std::string path() const {
+				return base_ + suffix_;
+			}
+
+			void set_archive_hook(std::function<void(const std::string&)> hook) {
+				archive_hook_ = std::move(hook);
+			}
+
+			// 외부에서 현재 파일을 옮기거나 지운 뒤 같은 경로로 다시 연다 (이어 쓰기, 새 파일의 현재 크기를 반환)
+			// 진행 중인 백그라운드 이름 변경이 끝나야 path()가 지금 쓰는 파일을 가리키므로 먼저 기다린다.
+			size_t reopen() {
+				if (housekeeper_) {
+					housekeeper_->drain();
+				}
+
+				file_.close();
+				file_.clear();
+				file_.open(path(), std::ios::app | mode_);
+				if (!file_.is_open()) return 0;
+				file_.seekp(0, std::ios::end);
+				return static_cast<size_t>(file_.tellp());
+			}
+
+			// 새 파일로 바꿨으면 true, 다음 파일이 준비되지 않아 미뤘으면 false
+			bool rotate() {
+				if (!file_.is_open()) return false;
+
+				if (housekeeper_ && !next_failed_.load(std::memory_order_acquire)) {
+					if (!next_ready_.load(std::memory_order_acquire)) {
+						return false;  // 다음 파일이 준비될 때까지 현재 파일에 계속 기록
+					}
+					switch_to_next();
+					return true;
+				}
+
+				file_.close();
+				rotate_archives(base_, max_files_, suffix_);
+
+				// 새 파일 생성
+				file_.open(path(), std::ios::out | mode_);
+
+				if (archive_hook_) {
+					archive_hook_(archive_path());
+				}
+				return true;
+			}
+
+		private:
+			std::string next_path() const {
+				return path() + ".next";
+			}
+
+			std::string archive_path() const {
+				return base_ + ".1" + suffix_;
+			}
+
+			// 미리 열어 둔 파일로 바꾸고, 이름 변경은 백그라운드 스레드에 맡긴다
+			void switch_to_next() {
+				std::unique_ptr<std::ofstream> next;
+				{
+					std::lock_guard<std::mutex> lock(next_mutex_);
+					next = std::move(next_file_);
+				}
+				next_ready_.store(false, std::memory_order_relaxed);
+
+				auto old_file = std::make_shared<std::ofstream>(std::move(file_));
+				file_ = std::move(*next);
+
+				housekeeper_->post([this, old_file] {
+					old_file->close();
+					try {
+						rotate_archives(base_, max_files_, suffix_);
+						std::filesystem::rename(next_path(), path());
+						if (archive_hook_) {
+							archive_hook_(archive_path());
+						}
+					}
+					catch (const std::exception& e) {
+						std::cerr << "Logger rotation error: " << e.what() << std::endl;
+					}
+					prepare_next();
+				});
+			}
+
+			// 백그라운드 스레드: 다음 파일을 미리 연다 (실패하면 동기식 로테이션으로 전환)
+			void prepare_next() {
+				auto next = std::make_unique<std::ofstream>(next_path(), std::ios::out | std::ios::trunc | mode_);
+				if (!next->is_open()) {
+					next_failed_.store(true, std::memory_order_release);
+					return;
+				}
+
+				{
+					std::lock_guard<std::mutex> lock(next_mutex_);
+					next_file_ = std::move(next);
+				}
+				next_ready_.store(true, std::memory_order_release);
+			}
+		};
+
+	} // namespace detail
+
+	// 파일 싱크 (크기 기준 로테이션, 로테이션 방식은 detail::RotatingFile 참고)
+	class FileSink : public FormattedSink {
+	private:
+		detail::RotatingFile output_;
+		size_t max_file_size_;
+		size_t current_size_;
+
+	public:
+		static constexpr const char* kDefaultPattern = "[%Y-%m-%d %H:%M:%S.%e] [%l] [%t] %v%k";
+
+		FileSink(const std::string& filename,
+			size_t max_file_size = 10 * 1024 * 1024,
+			int max_files = 5,
+			const std::string& pattern = kDefaultPattern)
+			: FormattedSink(pattern),
+			output_(filename, max_files), max_file_size_(max_file_size), current_size_(output_.initial_size()) {
+		}
+
+		// 로테이션으로 새 아카이브(<filename>.1)가 생길 때마다 호출 (압축/업로드 등, add_sink 전에 설정)
+		// POSIX에서는 백그라운드 스레드에서 실행되므로 오래 걸려도 로깅을 막지 않는다.
+		void set_archive_hook(std::function<void(const std::string& archive_path)> hook) {
+			output_.set_archive_hook(std::move(hook));
+		}
+
+		void write(const LogEntry& entry) override {
+			if (!output_.is_open()) return;
+
+			line_buffer_.clear();
+			formatter_.format(entry, line_buffer_);
+			line_buffer_ += '\n';
+
+			output_.stream().write(line_buffer_.data(), static_cast<std::streamsize>(line_buffer_.size()));
+			current_size_ += line_buffer_.size();
+
+			check_and_rotate();
+		}
+
+		// 배치 전체를 한 버퍼에 포맷해서 한 번에 기록 (로테이션 경계에서만 나눠 씀)
+		void write_batch(const LogEntry* entries, size_t count) override {
+			if (!output_.is_open()) return;
+
+			line_buffer_.clear();
+			for (size_t i = 0; i < count; ++i) {
+				size_t line_start = line_buffer_.size();
+				formatter_.format(entries[i], line_buffer_);
+				line_buffer_ += '\n';
+				current_size_ += line_buffer_.size() - line_start;
+
+				if (current_size_ >= max_file_size_) {
+					output_.stream().write(line_buffer_.data(), static_cast<std::streamsize>(line_buffer_.size()));
+					line_buffer_.clear();
+					rotate_file();
+					if (!output_.is_open()) return;
+				}
+			}
+
+			if (!line_buffer_.empty()) {
+				output_.stream().write(line_buffer_.data(), static_cast<std::streamsize>(line_buffer_.size()));
+			}
+		}
+
+		void flush() override {
+			if (output_.is_open()) {
+				output_.stream().flush();
+			}
+		}
+
+		void reopen() override {
+			current_size_ = output_.reopen();
+		}
+
+	private:
+		inline void check_and_rotate() {
+			if (current_size_ >= max_file_size_) {
+				rotate_file();
+			}
+		}
+
+		inline void rotate_file() {
+			if (output_.rotate()) {
+				current_size_ = 0;
+			}
+		}
+	};
+
+	namespace detail {
+
+		// 8바이트 중 JSON 이스케이프가 필요한 바이트(제어 문자, ", \)가 있는지 (SWAR 비트 연산)
+		inline bool json_needs_escape(uint64_t word) {
+			constexpr uint64_t kOnes = 0x0101010101010101ULL;
+			constexpr uint64_t kHighs = 0x8080808080808080ULL;
+			uint64_t control = (word - kOnes * 0x20) & ~word & kHighs;
+			uint64_t quote = word ^ (kOnes * '"');
+			uint64_t backslash = word ^ (kOnes * '\\');
+			quote = (quote - kOnes) & ~quote & kHighs;
+			backslash = (backslash - kOnes) & ~backslash & kHighs;
+			return (control | quote | backslash) != 0;
+		}
+
+		// text를 JSON 문자열 내용으로 이스케이프해서 out 뒤에 붙인다
+		// 이스케이프할 문자가 없는 구간은 8바이트씩 검사하고 한 번에 복사한다 (UTF-8 바이트는 그대로 둔다).
+		inline void append_json_escaped(std::string& out, std::string_view text) {
+			static const char kHex[] = "0123456789abcdef";
+			const char* data = text.data();
+			size_t size = text.size();
+			size_t start = 0;
+			size_t i = 0;
+
+			while (i < size) {
+				if (size - i >= 8) {
+					uint64_t word;
+					std::memcpy(&word, data + i, sizeof(word));
+					if (!json_needs_escape(word)) {
+						i += 8;
+						continue;
+					}
+				}
+
+				unsigned char c = static_cast<unsigned char>(data[i]);
+				if (c >= 0x20 && c != '"' && c != '\\') {
+					++i;
+					continue;
+				}
+
+				out.append(data + start, i - start);
+				switch (c) {
+				case '"':  out += "\\\""; break;
+				case '\\': out += "\\\\"; break;
+				case '\n': out += "\\n"; break;
+				case '\r': out += "\\r"; break;
+				case '\t': out += "\\t"; break;
+				case '\b': out += "\\b"; break;
+				case '\f': out += "\\f"; break;
+				default: {
+					char escaped[6] = { '\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF] };
+					out.append(escaped, sizeof(escaped));
+					break;
+				}
+				}
+				start = ++i;
+			}
+			out.append(data + start, size - start);
+		}
+
+		inline void append_json_field_value(std::string& out, const LogField& field) {
+			switch (field.type) {
+			case 'i': append_number(out, field.i); return;
+			case 'u': append_number(out, field.u); return;
+			case 'f':
+			case 'd':
+				// JSON에는 NaN/Inf가 없다
+				if (!std::isfinite(field.d)) {
+					out += "null";
+				}
+				else if (field.type == 'f') {
+					append_number(out, static_cast<float>(field.d));
+				}
+				else {
+					append_number(out, field.d);
+				}
+				return;
+			case 'b': out += field.b ? "true" : "false"; return;
+			case 'p':
+				out += "\"0x";
+				append_hex(out, field.u);
+				out += '"';
+				return;
+			case 'c':
+				out += '"';
+				append_json_escaped(out, std::string_view(&field.c, 1));
+				out += '"';
+				return;
+			case 's':
+				out += '"';
+				append_json_escaped(out, field.s);
+				out += '"';
+				return;
+			default:
+				out += "null";
+				return;
+			}
+		}
+
+	} // namespace detail
+
+	// 한 줄에 JSON 객체 하나를 기록하는 파일 싱크 (JSON Lines)
+	// {"ts":"2024-06-02 10:30:45.123","level":"INFO","thread":"1403","logger":"net.rpc","msg":"login","user":"bob","port":8080}
+	// kv() 필드는 타입을 유지한 최상위 키가 되며, logger는 이름 있는 로거일 때만 들어간다.
+	// 재사용 줄 버퍼에 직접 인코딩하므로 줄마다 메모리 할당이 없다. 로테이션은 FileSink와 같다.
+	class JsonSink : public LogSink {
+	private:
+		detail::RotatingFile output_;
+		size_t max_file_size_;
+		size_t current_size_;
+		std::string line_buffer_;
+		detail::TimestampCache timestamp_cache_;
+		detail::ThreadIdCache thread_ids_;
+
+		static std::string_view level_name(LogLevel level) {
+			switch (level) {
+			case LogLevel::DEBUG: return "DEBUG";
+			case LogLevel::INFO:  return "INFO";
+			case LogLevel::WARN:  return "WARN";
+			case LogLevel::ERROR: return "ERROR";
+			case LogLevel::FATAL: return "FATAL";
+			default: return "UNKNOWN";
+			}
+		}
+
+		void encode(const LogEntry& entry) {
+			line_buffer_ += "{\"ts\":\"";
+			line_buffer_ += timestamp_cache_.format(entry.timestamp);
+			line_buffer_ += "\",\"level\":\"";
+			line_buffer_ += level_name(entry.level);
+			line_buffer_ += "\",\"thread\":\"";
+			line_buffer_ += thread_ids_.text(entry.thread_id);
+			if (entry.logger_name && *entry.logger_name) {
+				line_buffer_ += "\",\"logger\":\"";
+				detail::append_json_escaped(line_buffer_, entry.logger_name);
+			}
+			line_buffer_ += "\",\"msg\":\"";
+			detail::append_json_escaped(line_buffer_, entry.message.view());
+			line_buffer_ += '"';
+
+			if (entry.field_count > 0) {
+				for_each_field(entry, [this](const LogField& field) {
+					line_buffer_ += ",\"";
+					detail::append_json_escaped(line_buffer_, field.key);
+					line_buffer_ += "\":";
+					detail::append_json_field_value(line_buffer_, field);
+				});
+			}
+			line_buffer_ += "}\n";
+		}
+
+		void rotate_file() {
+			if (output_.rotate()) {
+				current_size_ = 0;
+			}
+		}
+
+	public:
+		JsonSink(const std::string& filename,
+			size_t max_file_size = 10 * 1024 * 1024,
+			int max_files = 5)
+			: output_(filename, max_files), max_file_size_(max_file_size), current_size_(output_.initial_size()) {
+			line_buffer_.reserve(512);
+		}
+
+		void set_archive_hook(std::function<void(const std::string& archive_path)> hook) {
+			output_.set_archive_hook(std::move(hook));
+		}
+
+		void write(const LogEntry& entry) override {
+			write_batch(&entry, 1);
+		}
+
+		void write_batch(const LogEntry* entries, size_t count) override {
+			if (!output_.is_open()) return;
+
+			line_buffer_.clear();
+			for (size_t i = 0; i < count; ++i) {
+				size_t line_start = line_buffer_.size();
+				encode(entries[i]);
+				current_size_ += line_buffer_.size() - line_start;
+
+				if (current_size_ >= max_file_size_) {
+					output_.stream().write(line_buffer_.data(), static_cast<std::streamsize>(line_buffer_.size()));
+					line_buffer_.clear();
+					rotate_file();
+					if (!output_.is_open()) return;
+				}
+			}
+
+			if (!line_buffer_.empty()) {
+				output_.stream().write(line_buffer_.data(), static_cast<std::streamsize>(line_buffer_.size()));
+			}
+		}
+
+		void flush() override {
+			if (output_.is_open()) {
+				output_.stream().flush();
+			}
+		}
+
+		void reopen() override {
+			current_size_ = output_.reopen();
+		}
+	};
+
+#if defined(CPPLOG_USE_ZSTD)
+	// zstd 스트리밍 압축 파일 싱크 (CPPLOG_USE_ZSTD를 정의하고 libzstd를 링크해야 사용 가능)
+	// <filename>.zst에 기록하고 아카이브는 <filename>.N.zst가 된다. 배치 버퍼를 워커 스레드에서 압축 스트림에 넣고,
+	// 플러시마다 프레임을 닫으므로 기록 중인 파일도 마지막 플러시 지점까지 압축을 풀 수 있다.
+	// max_file_size는 압축 전 바이트 기준이다.
+	class CompressedFileSink : public FormattedSink {
+	private:
+		detail::RotatingFile output_;
+		size_t max_file_size_;
+		size_t current_size_;
+		ZSTD_CCtx* cctx_;
+		std::vector<char> out_buffer_;
+		bool frame_open_;
+
+	public:
+		// 이어 쓰면 비정상 종료로 잘린 프레임 뒤에 붙을 수 있으므로 기존 파일은 아카이브로 밀고 새로 시작한다
+		CompressedFileSink(const std::string& filename,
+			size_t max_file_size = 10 * 1024 * 1024,
+			int max_files = 5,
+			int compression_level = 3,
+			const std::string& pattern = FileSink::kDefaultPattern)
+			: FormattedSink(pattern),
+			output_(filename, max_files, ".zst", std::ios::binary, false),
+			max_file_size_(max_file_size), current_size_(0),
+			cctx_(ZSTD_createCCtx()), out_buffer_(ZSTD_CStreamOutSize()), frame_open_(false) {
+
+			if (cctx_) {
+				ZSTD_CCtx_setParameter(cctx_, ZSTD_c_compressionLevel, compression_level);
+			}
+		}
+
+		~CompressedFileSink() {
+			end_frame();
+			ZSTD_freeCCtx(cctx_);
+		}
+
+		CompressedFileSink(const CompressedFileSink&) = delete;
+		CompressedFileSink& operator=(const CompressedFileSink&) = delete;
+
+		void set_archive_hook(std::function<void(const std::string& archive_path)> hook) {
+			output_.set_archive_hook(std::move(hook));
+		}
+
+		void write(const LogEntry& entry) override {
+			write_batch(&entry, 1);
+		}
+
+		void write_batch(const LogEntry* entries, size_t count) override {
+			if (!output_.is_open() || !cctx_) return;
+
+			line_buffer_.clear();
+			for (size_t i = 0; i < count; ++i) {
+				size_t line_start = line_buffer_.size();
+				formatter_.format(entries[i], line_buffer_);
+				line_buffer_ += '\n';
+				current_size_ += line_buffer_.size() - line_start;
+
+				if (current_size_ >= max_file_size_) {
+					compress(line_buffer_.data(), line_buffer_.size());
+					line_buffer_.clear();
+					rotate_file();
+					if (!output_.is_open()) return;
+				}
+			}
+
+			if (!line_buffer_.empty()) {
+				compress(line_buffer_.data(), line_buffer_.size());
+			}
+		}
+
+		// 프레임을 닫아서 여기까지 기록한 내용을 온전히 읽을 수 있게 한다
+		void flush() override {
+			if (!output_.is_open()) return;
+			end_frame();
+			output_.stream().flush();
+		}
+
+		// 프레임은 flush에서 닫혔으므로 이어 붙여도 올바른 zstd 파일이다 (크기는 새 파일일 때만 0부터 다시 센다)
+		void reopen() override {
+			end_frame();
+			if (output_.reopen() == 0) {
+				current_size_ = 0;
+			}
+		}
+
+	private:
+		void compress(const char* data, size_t size) {
+			ZSTD_inBuffer in = { data, size, 0 };
+			while (in.pos < in.size) {
+				ZSTD_outBuffer out = { out_buffer_.data(), out_buffer_.size(), 0 };
+				size_t result = ZSTD_compressStream2(cctx_, &out, &in, ZSTD_e_continue);
+				if (ZSTD_isError(result)) {
+					ZSTD_CCtx_reset(cctx_, ZSTD_reset_session_only);
+					frame_open_ = false;
+					throw std::runtime_error(ZSTD_getErrorName(result));
+				}
+				output_.stream().write(out_buffer_.data(), static_cast<std::streamsize>(out.pos));
+			}
+			frame_open_ = true;
+		}
+
+		void end_frame() {
+			if (!frame_open_ || !output_.is_open()) return;
+
+			ZSTD_inBuffer in = { nullptr, 0, 0 };
+			size_t remaining = 0;
+			do {
+				ZSTD_outBuffer out = { out_buffer_.data(), out_buffer_.size(), 0 };
+				remaining = ZSTD_compressStream2(cctx_, &out, &in, ZSTD_e_end);
+				if (ZSTD_isError(remaining)) {
+					ZSTD_CCtx_reset(cctx_, ZSTD_reset_session_only);
+					break;
+				}
+				output_.stream().write(out_buffer_.data(), static_cast<std::streamsize>(out.pos));
+			} while (remaining != 0);
+			frame_open_ = false;
+		}
+
+		// 아카이브가 완결된 프레임으로 끝나도록 프레임을 닫고 로테이션
+		void rotate_file() {
+			end_frame();
+			if (output_.rotate()) {
+				current_size_ = 0;
+			}
+		}
+	};
+#endif
+
+	namespace detail {
+
+		// 바이너리 로그 파일 형식 (BinaryFileSink / BinaryLogReader)
+		//   헤더: "CPPLOGB" + 버전(1)
+		//   'F' id fmt_len fmt types_len types  : 포맷 사전 항목 (파일마다 처음 쓰일 때 한 번)
+		//   'T' index len text                  : 스레드 ID 문자열 (파일마다 처음 쓰일 때 한 번)
+		//   'E' ts_delta level thread format args_len args : 로그 항목
+		// 정수는 LEB128 varint, ts_delta는 직전 항목과의 나노초 차이(zigzag), args는 지연 포맷 인자 인코딩 그대로
+		constexpr char kBinaryLogMagic[8] = { 'C', 'P', 'P', 'L', 'O', 'G', 'B', 1 };
+
+		inline void append_varint(std::string& out, uint64_t value) {
+			while (value >= 0x80) {
+				out += static_cast<char>((value & 0x7F) | 0x80);
+				value >>= 7;
+			}
+			out += static_cast<char>(value);
+		}
+
+		inline bool read_varint(const unsigned char*& cursor, const unsigned char* end, uint64_t& value) {
+			value = 0;
+			for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+				unsigned char byte = *cursor++;
+				value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0) return true;
+			}
+			return false;
+		}
+
+		inline uint64_t zigzag_encode(int64_t value) {
+			return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+		}
+
+		inline int64_t zigzag_decode(uint64_t value) {
+			return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+		}
+
+		inline int64_t to_unix_nanoseconds(std::chrono::system_clock::time_point tp) {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+		}
+
+	} // namespace detail
+
+	// 바이너리 로그 파일 싱크
+	// 포맷 문자열은 파일마다 사전에 한 번만 기록하고, 항목은 시각 차이/레벨/스레드 번호/포맷 번호/인자 바이트만 남긴다.
+	// 지연 포맷(set_deferred_formatting)으로 기록된 항목은 텍스트 포맷 없이 저장되며, 그 외 항목은 완성된 메시지를
+	// 문자열 인자 하나로 저장한다. log_decoder로 FileSink와 같은 텍스트 형식으로 되돌릴 수 있다.
+	class BinaryFileSink : public LogSink {
+	private:
+		struct FormatKey {
+			const char* format;
+			const char* types;
+			bool operator==(const FormatKey& other) const {
+				return format == other.format && types == other.types;
+			}
+		};
+
+		struct FormatKeyHash {
+			size_t operator()(const FormatKey& key) const {
+				return std::hash<const void*>()(key.format) * 31 + std::hash<const void*>()(key.types);
+			}
+		};
+
+		// 호출 스레드에서 포맷된 메시지는 "{}" 포맷 + 문자열 인자 하나로 기록
+		static constexpr const char* kTextFormat = "{}";
+		static constexpr const char* kTextTypes = "s";
+
+		detail::RotatingFile output_;
+		size_t max_file_size_;
+		size_t current_size_;
+		std::string buffer_;
+		std::unordered_map<FormatKey, uint32_t, FormatKeyHash> formats_;
+		std::unordered_map<std::thread::id, uint32_t> threads_;
+		int64_t last_timestamp_;
+
+	public:
+		// 이어 쓰면 사전이 끊기므로 기존 파일은 아카이브로 밀고 새로 시작한다
+		BinaryFileSink(const std::string& filename,
+			size_t max_file_size = 10 * 1024 * 1024,
+			int max_files = 5)
+			: output_(filename, max_files, "", std::ios::binary, false),
+			max_file_size_(max_file_size), current_size_(0), last_timestamp_(0) {
+			buffer_.reserve(4096);
+			start_file();
+			write_buffer();
+		}
+
+		void set_archive_hook(std::function<void(const std::string& archive_path)> hook) {
+			output_.set_archive_hook(std::move(hook));
+		}
+
+		void write(const LogEntry& entry) override {
+			write_batch(&entry, 1);
+		}
+
+		void write_batch(const LogEntry* entries, size_t count) override {
+			if (!output_.is_open()) return;
+
+			for (size_t i = 0; i < count; ++i) {
+				append_record(entries[i]);
+
+				if (current_size_ + buffer_.size() >= max_file_size_) {
+					write_buffer();
+					if (output_.rotate()) {
+						current_size_ = 0;
+						start_file();
+					}
+					if (!output_.is_open()) return;
+				}
+			}
+			write_buffer();
+		}
+
+		void flush() override {
+			if (output_.is_open()) {
+				output_.stream().flush();
+			}
+		}
+
+		// 같은 파일이면 사전을 이어 쓰고, 옮겨져서 새 파일이 열렸으면 헤더부터 다시 시작한다
+		void reopen() override {
+			current_size_ = output_.reopen();
+			if (current_size_ == 0 && output_.is_open()) {
+				start_file();
+				write_buffer();
+			}
+		}
+
+		bool uses_message_text() const override {
+			return false;
+		}
+
+	private:
+		// 새 파일: 헤더를 쓰고 사전을 비운다
+		void start_file() {
+			formats_.clear();
+			threads_.clear();
+			last_timestamp_ = 0;
+			buffer_.append(detail::kBinaryLogMagic, sizeof(detail::kBinaryLogMagic));
+		}
+
+		void write_buffer() {
+			if (buffer_.empty()) return;
+			output_.stream().write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+			current_size_ += buffer_.size();
+			buffer_.clear();
+		}
+
+		uint32_t format_id(const char* format, const char* types) {
+			auto found = formats_.find({ format, types });
+			if (found != formats_.end()) return found->second;
+
+			auto id = static_cast<uint32_t>(formats_.size());
+			formats_.emplace(FormatKey{ format, types }, id);
+
+			size_t format_length = std::strlen(format);
+			size_t types_length = std::strlen(types);
+			buffer_ += 'F';
+			detail::append_varint(buffer_, id);
+			detail::append_varint(buffer_, format_length);
+			buffer_.append(format, format_length);
+			detail::append_varint(buffer_, types_length);
+			buffer_.append(types, types_length);
+			return id;
+		}
+
+		uint32_t thread_index(std::thread::id thread_id) {
+			auto found = threads_.find(thread_id);
+			if (found != threads_.end()) return found->second;
+
+			auto index = static_cast<uint32_t>(threads_.size());
+			threads_.emplace(thread_id, index);
+
+			std::ostringstream oss;
+			oss << thread_id;
+			std::string text = oss.str();
+			buffer_ += 'T';
+			detail::append_varint(buffer_, index);
+			detail::append_varint(buffer_, text.size());
+			buffer_ += text;
+			return index;
+		}
+
+		void append_record(const LogEntry& entry) {
+			bool packed = entry.format && entry.arg_types;
+			uint32_t format = packed ? format_id(entry.format, entry.arg_types) : format_id(kTextFormat, kTextTypes);
+			uint32_t thread = thread_index(entry.thread_id);
+
+			int64_t timestamp = detail::to_unix_nanoseconds(entry.timestamp);
+			buffer_ += 'E';
+			detail::append_varint(buffer_, detail::zigzag_encode(timestamp - last_timestamp_));
+			buffer_ += static_cast<char>(entry.level);
+			detail::append_varint(buffer_, thread);
+			detail::append_varint(buffer_, format);
+			last_timestamp_ = timestamp;
+
+			if (packed) {
+				detail::append_varint(buffer_, entry.format_args_size());
+				buffer_.append(reinterpret_cast<const char*>(entry.message.args()), entry.format_args_size());
+			}
+			else {
+				auto length = static_cast<uint32_t>(entry.message.size());
+				detail::append_varint(buffer_, sizeof(length) + length);
+				buffer_.append(reinterpret_cast<const char*>(&length), sizeof(length));
+				buffer_.append(entry.message.data(), entry.message.size());
+			}
+		}
+	};
+
+	// BinaryFileSink가 쓴 파일 내용을 항목 단위로 복원
+	class BinaryLogReader {
+	public:
+		struct Record {
+			std::chrono::system_clock::time_point timestamp;
+			LogLevel level;
+			std::string_view thread_id;
+			std::string message;
+		};
+
+		explicit BinaryLogReader(std::string_view data)
+			: cursor_(reinterpret_cast<const unsigned char*>(data.data())),
+			end_(cursor_ + data.size()), last_timestamp_(0) {
+			if (data.size() < sizeof(detail::kBinaryLogMagic)
+				|| std::memcmp(data.data(), detail::kBinaryLogMagic, sizeof(detail::kBinaryLogMagic)) != 0) {
+				error_ = "not a CppLog binary file";
+				cursor_ = end_;
+				return;
+			}
+			cursor_ += sizeof(detail::kBinaryLogMagic);
+		}
+
+		// 다음 항목을 읽음 (끝이거나 데이터가 잘못되었으면 false, 이유는 error())
+		bool next(Record& record) {
+			while (cursor_ < end_) {
+				char tag = static_cast<char>(*cursor_++);
+				switch (tag) {
+				case 'F': {
+					uint64_t id = 0;
+					std::string_view format, types;
+					if (!read_varint(id) || !read_bytes(format) || !read_bytes(types)) return fail("truncated format record");
+					if (id != formats_.size()) return fail("unexpected format id");
+					formats_.push_back({ std::string(format), std::string(types) });
+					break;
+				}
+				case 'T': {
+					uint64_t index = 0;
+					std::string_view text;
+					if (!read_varint(index) || !read_bytes(text)) return fail("truncated thread record");
+					if (index != threads_.size()) return fail("unexpected thread index");
+					threads_.emplace_back(text);
+					break;
+				}
+				case 'E':
+					return read_entry(record);
+				default:
+					return fail("unknown record tag");
+				}
+			}
+			return false;
+		}
+
+		const std::string& error() const {
+			return error_;
+		}
+
+	private:
+		const unsigned char* cursor_;
+		const unsigned char* end_;
+		int64_t last_timestamp_;
+		std::vector<std::pair<std::string, std::string>> formats_;
+		std::vector<std::string> threads_;
+		std::string error_;
+
+		bool fail(const char* reason) {
+			error_ = reason;
+			cursor_ = end_;
+			return false;
+		}
+
+		bool read_varint(uint64_t& value) {
+			return detail::read_varint(cursor_, end_, value);
+		}
+
+		bool read_bytes(std::string_view& bytes) {
+			uint64_t length = 0;
+			if (!read_varint(length) || static_cast<uint64_t>(end_ - cursor_) < length) return false;
+			bytes = std::string_view(reinterpret_cast<const char*>(cursor_), static_cast<size_t>(length));
+			cursor_ += length;
+			return true;
+		}
+
+		bool read_entry(Record& record) {
+			uint64_t delta = 0, thread = 0, format = 0;
+			if (!read_varint(delta) || cursor_ >= end_) return fail("truncated entry");
+			unsigned char level = *cursor_++;
+			std::string_view args;
+			if (!read_varint(thread) || !read_varint(format) || !read_bytes(args)) return fail("truncated entry");
+			if (thread >= threads_.size() || format >= formats_.size() || level > static_cast<unsigned char>(LogLevel::FATAL)) {
+				return fail("invalid entry");
+			}
+
+			last_timestamp_ += detail::zigzag_decode(delta);
+			record.timestamp = std::chrono::system_clock::time_point(
+				std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(last_timestamp_)));
+			record.level = static_cast<LogLevel>(level);
+			record.thread_id = threads_[thread];
+
+			std::ostringstream oss;
+			const auto& entry_format = formats_[format];
+			detail::format_packed(oss, entry_format.first, entry_format.second.c_str(),
+				reinterpret_cast<const unsigned char*>(args.data()), args.size());
+			record.message = oss.str();
+			return true;
+		}
+	};
+
+#if !defined(_WIN32)
+	// 메모리 맵 파일 싱크 (POSIX 전용)
+	// max_file_size 크기의 세그먼트를 미리 할당해서 매핑하고, 줄을 memcpy로 기록하므로 줄마다 시스템 콜이 없다.
+	// 로테이션/종료 시 실제 기록한 크기로 ftruncate한다. 비정상 종료로 남은 0 바이트 꼬리는 다시 열 때 건너뛴다.
+	class MmapFileSink : public FormattedSink {
+	private:
+		std::string filename_;
+		size_t max_file_size_;
+		int max_files_;
+		int fd_;
+		char* mapping_;
+		size_t mapping_size_;
+		std::atomic<size_t> tail_;
+
+	public:
+		MmapFileSink(const std::string& filename,
+			size_t max_file_size = 10 * 1024 * 1024,
+			int max_files = 5,
+			const std::string& pattern = FileSink::kDefaultPattern)
+			: FormattedSink(pattern),
+			filename_(filename), max_file_size_((std::max)(max_file_size, static_cast<size_t>(4096))),
+			max_files_(max_files), fd_(-1), mapping_(nullptr), mapping_size_(0), tail_(0) {
+
+			// 디렉터리 생성
+			std::filesystem::path file_path(filename);
+			if (file_path.has_parent_path()) {
+				std::filesystem::create_directories(file_path.parent_path());
+			}
+
+			open_segment();
+		}
+
+		~MmapFileSink() {
+			close_segment();
+		}
+
+		MmapFileSink(const MmapFileSink&) = delete;
+		MmapFileSink& operator=(const MmapFileSink&) = delete;
+
+		void write(const LogEntry& entry) override {
+			if (!mapping_) return;
+
+			line_buffer_.clear();
+			formatter_.format(entry, line_buffer_);
+			line_buffer_ += '\n';
+			append(line_buffer_.data(), line_buffer_.size());
+		}
+
+		void write_batch(const LogEntry* entries, size_t count) override {
+			for (size_t i = 0; i < count && mapping_; ++i) {
+				line_buffer_.clear();
+				formatter_.format(entries[i], line_buffer_);
+				line_buffer_ += '\n';
+				append(line_buffer_.data(), line_buffer_.size());
+			}
+		}
+
+		// 매핑에 쓴 내용은 이미 페이지 캐시에 있으므로 ofstream::flush와 같은 수준이 되려면 할 일이 없다
+		void flush() override {}
+
+		// 현재 세그먼트에 기록된 바이트 수
+		size_t size() const {
+			return tail_.load(std::memory_order_acquire);
+		}
+
+		// 같은 경로로 세그먼트를 다시 매핑한다 (logrotate가 옮긴 파일은 실제 크기로 잘라서 닫는다)
+		// 로테이션은 워커에서 바로 하므로 먼저 끝내야 할 보조 스레드 작업은 없다.
+		void reopen() override {
+			close_segment();
+			tail_.store(0, std::memory_order_release);
+			open_segment();
+		}
+
+	private:
+		void append(const char* data, size_t length) {
+			size_t tail = tail_.load(std::memory_order_relaxed);
+			if (tail + length > max_file_size_ && tail > 0) {
+				rotate_file();
+				if (!mapping_) return;
+				tail = 0;
+			}
+
+			// 세그먼트보다 긴 줄은 잘라서 기록
+			length = (std::min)(length, max_file_size_ - tail);
+			std::memcpy(mapping_ + tail, data, length);
+			tail_.store(tail + length, std::memory_order_release);
+		}
+
+		void open_segment() {
+			fd_ = ::open(filename_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+			if (fd_ < 0) return;
+
+			struct stat st;
+			size_t existing = 0;
+			if (::fstat(fd_, &st) == 0) {
+				existing = static_cast<size_t>(st.st_size);
+			}
+
+			size_t capacity = (std::max)(existing, max_file_size_);
+			// fallocate를 지원하지 않는 파일시스템에서만 ftruncate로 늘린다. 디스크가 가득 찬 경우(ENOSPC 등)에
+			// 희소 파일을 매핑하면 memcpy가 SIGBUS로 프로세스를 죽이므로 여는 데 실패한 것으로 처리한다.
+			int result = ::posix_fallocate(fd_, 0, static_cast<off_t>(capacity));
+			bool allocated = result == 0
+				|| ((result == EOPNOTSUPP || result == EINVAL) && ::ftruncate(fd_, static_cast<off_t>(capacity)) == 0);
+			void* mapping = allocated
+				? ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0)
+				: MAP_FAILED;
+			if (mapping == MAP_FAILED) {
+				::ftruncate(fd_, static_cast<off_t>(existing));
+				::close(fd_);
+				fd_ = -1;
+				return;
+			}
+			mapping_ = static_cast<char*>(mapping);
+			mapping_size_ = capacity;
+
+			// 이전 실행이 ftruncate 전에 끝났다면 미리 할당된 0 바이트 꼬리를 건너뛴다
+			size_t tail = existing;
+			while (tail > 0 && mapping_[tail - 1] == '\0') {
+				--tail;
+			}
+			tail_.store(tail, std::memory_order_release);
+
+			// 기존 파일이 이미 세그먼트 크기 이상이면 바로 로테이션
+			if (capacity > max_file_size_ || tail >= max_file_size_) {
+				rotate_file();
+			}
+		}
+
+		void close_segment() {
+			if (!mapping_) return;
+
+			::munmap(mapping_, mapping_size_);
+			mapping_ = nullptr;
+			mapping_size_ = 0;
+
+			// 미리 할당한 꼬리를 잘라서 실제 크기로 맞춤
+			::ftruncate(fd_, static_cast<off_t>(tail_.load(std::memory_order_relaxed)));
+			::close(fd_);
+			fd_ = -1;
+		}
+
+		void rotate_file() {
+			close_segment();
+			detail::rotate_archives(filename_, max_files_);
+			tail_.store(0, std::memory_order_release);
+			open_segment();
+		}
+	};
+#endif
+
+#if !defined(_WIN32)
+	// NetworkSink 설정
+	struct NetworkSinkOptions {
+		std::string app_name = "cpplog";
+		std::string hostname;                               // 비어 있으면 gethostname()
+		int facility = 16;                                  // syslog facility (16 = local0)
+		size_t max_buffer = 4 * 1024 * 1024;                // TCP 송신 대기 버퍼 (가득 차면 새 메시지를 버림)
+		size_t max_datagram = 2048;                         // UDP 메시지 최대 크기 (넘으면 자름)
+		std::chrono::milliseconds min_backoff{ 100 };       // 재연결 대기 시작값 (실패할 때마다 두 배)
+		std::chrono::milliseconds max_backoff{ 30000 };
+		std::chrono::milliseconds connect_timeout{ 5000 };
+	};
+
+	// 원격 수집기로 RFC 5424 syslog 메시지를 보내는 싱크 (POSIX 전용)
+	// UDP는 메시지마다 데이터그램 하나, TCP는 옥텟 카운팅 프레임(RFC 6587)으로 보낸다.
+	// 소켓은 논블로킹이라 수집기가 느려도 워커를 막지 않는다. TCP는 자체 버퍼에 모아 두었다가
+	// write/flush 때마다 보낼 수 있는 만큼만 보내고, 연결이 끊기면 backoff를 늘려 가며 다시 연결한다.
+	// 주소는 생성자에서 한 번 해석하며, 실패하면 워커 대신 보조 스레드에서 다시 해석한다.
+	class NetworkSink : public LogSink {
+	public:
+		enum class Protocol { Udp, Tcp };
+
+	private:
+		struct Address {
+			sockaddr_storage storage;
+			socklen_t length;
+			int family;
+		};
+
+		std::string host_;
+		std::string port_;
+		Protocol protocol_;
+		NetworkSinkOptions options_;
+		std::string header_;            // " HOSTNAME APP-NAME PROCID "
+
+		std::vector<Address> addresses_;
+		size_t next_address_ = 0;
+		std::mutex resolve_mutex_;
+		std::vector<Address> resolved_;  // 보조 스레드의 재해석 결과 (resolve_mutex_ 보호)
+		std::atomic<bool> resolving_{ false };
+
+		int fd_ = -1;
+		bool connecting_ = false;
+		std::chrono::steady_clock::time_point connect_deadline_;
+		std::chrono::steady_clock::time_point next_attempt_;
+		std::chrono::milliseconds backoff_;
+
+		// TCP 송신 버퍼: [head_, sent_)는 보내다 만 첫 프레임, frames_는 아직 다 보내지 못한 프레임 길이
+		std::string buffer_;
+		size_t head_ = 0;
+		size_t sent_ = 0;
+		std::deque<size_t> frames_;
+
+		std::string message_;
+		std::time_t cached_second_ = -1;
+		char cached_time_[24] = {};
+
+		std::atomic<uint64_t> bytes_sent_{ 0 };
+		std::atomic<uint64_t> dropped_{ 0 };
+
+		std::unique_ptr<detail::Housekeeper> resolver_;   // 마지막에 선언: 먼저 소멸해 남은 작업을 끝낸다
+
+		static int severity(LogLevel level) {
+			switch (level) {
+			case LogLevel::DEBUG: return 7;
+			case LogLevel::INFO:  return 6;
+			case LogLevel::WARN:  return 4;
+			case LogLevel::ERROR: return 3;
+			case LogLevel::FATAL: return 2;
+			default: return 6;
+			}
+		}
+
+		static std::vector<Address> resolve(const std::string& host, const std::string& port, Protocol protocol) {
+			addrinfo hints{};
+			hints.ai_family = AF_UNSPEC;
+			hints.ai_socktype = protocol == Protocol::Tcp ? SOCK_STREAM : SOCK_DGRAM;
+
+			std::vector<Address> addresses;
+			addrinfo* result = nullptr;
+			if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0) {
+				return addresses;
+			}
+			for (addrinfo* info = result; info; info = info->ai_next) {
+				Address address{};
+				std::memcpy(&address.storage, info->ai_addr, info->ai_addrlen);
+				address.length = static_cast<socklen_t>(info->ai_addrlen);
+				address.family = info->ai_family;
+				addresses.push_back(address);
+			}
+			::freeaddrinfo(result);
+			return addresses;
+		}
+
+		void drop(uint64_t count) {
+			dropped_.store(dropped_.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+		}
+
+		void add_sent(size_t bytes) {
+			bytes_sent_.store(bytes_sent_.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+		}
+
+		void close_socket() {
+			if (fd_ >= 0) {
+				::close(fd_);
+				fd_ = -1;
+			}
+			connecting_ = false;
+
+			// 보내다 만 프레임은 새 연결에서 이어 보낼 수 없으므로 버린다
+			if (sent_ > head_ && !frames_.empty()) {
+				head_ += frames_.front();
+				frames_.pop_front();
+				drop(1);
+			}
+			sent_ = head_;
+		}
+
+		void schedule_retry(std::chrono::steady_clock::time_point now) {
+			next_attempt_ = now + backoff_;
+			backoff_ = (std::min)(backoff_ * 2, options_.max_backoff);
+		}
+
+		void fail(std::chrono::steady_clock::time_point now) {
+			close_socket();
+			schedule_retry(now);
+		}
+
+		void start_resolve() {
+			if (resolving_.exchange(true)) return;
+			if (!resolver_) {
+				resolver_ = std::make_unique<detail::Housekeeper>();
+			}
+			resolver_->post([this] {
+				std::vector<Address> addresses = resolve(host_, port_, protocol_);
+				{
+					std::lock_guard<std::mutex> lock(resolve_mutex_);
+					resolved_ = std::move(addresses);
+				}
+				resolving_.store(false, std::memory_order_release);
+			});
+		}
+
+		// 연결되어 있으면 true (TCP 연결 중이면 완료 여부만 확인하고 기다리지 않는다)
+		bool ensure_connected(std::chrono::steady_clock::time_point now) {
+			if (fd_ >= 0 && !connecting_) return true;
+
+			if (connecting_) {
+				pollfd pfd{ fd_, POLLOUT, 0 };
+				if (::poll(&pfd, 1, 0) <= 0) {
+					if (now >= connect_deadline_) fail(now);
+					return false;
+				}
+				int error = 0;
+				socklen_t length = sizeof(error);
+				if (::getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+					fail(now);
+					return false;
+				}
+				connecting_ = false;
+				backoff_ = options_.min_backoff;
+				return true;
+			}
+
+			if (now < next_attempt_) return false;
+
+			if (addresses_.empty()) {
+				std::lock_guard<std::mutex> lock(resolve_mutex_);
+				addresses_.swap(resolved_);
+			}
+			if (addresses_.empty()) {
+				start_resolve();
+				schedule_retry(now);
+				return false;
+			}
+
+			const Address& address = addresses_[next_address_++ % addresses_.size()];
+			int type = protocol_ == Protocol::Tcp ? SOCK_STREAM : SOCK_DGRAM;
+			int fd = ::socket(address.family, type, 0);
+			if (fd < 0) {
+				schedule_retry(now);
+				return false;
+			}
+			::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+			::fcntl(fd, F_SETFD, FD_CLOEXEC);
+#if defined(SO_NOSIGPIPE)
+			int one = 1;
+			::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+			if (::connect(fd, reinterpret_cast<const sockaddr*>(&address.storage), address.length) == 0) {
+				fd_ = fd;
+				backoff_ = options_.min_backoff;
+				return true;
+			}
+			if (errno == EINPROGRESS) {
+				fd_ = fd;
+				connecting_ = true;
+				connect_deadline_ = now + options_.connect_timeout;
+				return false;
+			}
+			::close(fd);
+			schedule_retry(now);
+			return false;
+		}
+
+		static int send_flags() {
+#if defined(MSG_NOSIGNAL)
+			return MSG_NOSIGNAL;
+#else
+			return 0;
+#endif
+		}
+
+		// 보낼 수 있는 만큼만 보낸다 (EAGAIN이면 다음 기회에)
+		void send_buffered(std::chrono::steady_clock::time_point now) {
+			if (sent_ == buffer_.size() || !ensure_connected(now)) return;
+
+			while (sent_ < buffer_.size()) {
+				ssize_t n = ::send(fd_, buffer_.data() + sent_, buffer_.size() - sent_, send_flags());
+				if (n < 0) {
+					if (errno == EINTR) continue;
+					if (errno != EAGAIN && errno != EWOULDBLOCK) fail(now);
+					break;
+				}
+				sent_ += static_cast<size_t>(n);
+				add_sent(static_cast<size_t>(n));
+				while (!frames_.empty() && head_ + frames_.front() <= sent_) {
+					head_ += frames_.front();
+					frames_.pop_front();
+				}
+			}
+
+			if (head_ == buffer_.size()) {
+				buffer_.clear();
+				head_ = sent_ = 0;
+			}
+			else if (head_ > buffer_.size() / 2) {
+				buffer_.erase(0, head_);
+				sent_ -= head_;
+				head_ = 0;
+			}
+		}
+
+		// "<PRI>1 TIMESTAMP HOSTNAME APP-NAME PROCID MSGID - MSG"
+		void build_message(const LogEntry& entry) {
+			using namespace std::chrono;
+			auto since_epoch = entry.timestamp.time_since_epoch();
+			std::time_t seconds = static_cast<std::time_t>(duration_cast<std::chrono::seconds>(since_epoch).count());
+			auto micros = duration_cast<microseconds>(since_epoch).count() % 1000000;
+			if (micros < 0) {
+				micros += 1000000;
+				--seconds;
+			}
+			if (seconds != cached_second_) {
+				std::tm tm{};
+				::gmtime_r(&seconds, &tm);
+				std::strftime(cached_time_, sizeof(cached_time_), "%Y-%m-%dT%H:%M:%S", &tm);
+				cached_second_ = seconds;
+			}
+
+			char prefix[64];
+			int length = std::snprintf(prefix, sizeof(prefix), "<%d>1 %s.%06dZ",
+				options_.facility * 8 + severity(entry.level), cached_time_, static_cast<int>(micros));
+
+			message_.assign(prefix, static_cast<size_t>(length));
+			message_ += header_;
+			message_ += entry.logger_name && *entry.logger_name ? entry.logger_name : "-";
+			message_ += " - ";
+			message_.append(entry.message.data(), entry.message.size());
+		}
+
+		void send_datagram(std::chrono::steady_clock::time_point now) {
+			if (!ensure_connected(now)) {
+				drop(1);
+				return;
+			}
+			size_t length = (std::min)(message_.size(), options_.max_datagram);
+			for (;;) {
+				ssize_t n = ::send(fd_, message_.data(), length, send_flags());
+				if (n >= 0) {
+					add_sent(static_cast<size_t>(n));
+					return;
+				}
+				if (errno == EINTR) continue;
+				drop(1);
+				// 수신 측이 없다는 ICMP 응답 등은 무시하고, 소켓 자체 오류만 다시 연다
+				if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNREFUSED) fail(now);
+				return;
+			}
+		}
+
+	public:
+		NetworkSink(const std::string& host, uint16_t port, Protocol protocol = Protocol::Udp,
+			NetworkSinkOptions options = {})
+			: host_(host), port_(std::to_string(port)), protocol_(protocol), options_(std::move(options)),
+			backoff_(options_.min_backoff) {
+			std::string hostname = options_.hostname;
+			if (hostname.empty()) {
+				char buffer[256] = {};
+				hostname = ::gethostname(buffer, sizeof(buffer) - 1) == 0 && buffer[0] ? buffer : "-";
+			}
+			header_ = " " + hostname + " " + (options_.app_name.empty() ? "-" : options_.app_name)
+				+ " " + std::to_string(::getpid()) + " ";
+
+			addresses_ = resolve(host_, port_, protocol_);
+		}
+
+		~NetworkSink() override {
+			// 마지막으로 한 번 보내 보고, 기다리지 않고 닫는다
+			send_buffered(std::chrono::steady_clock::now());
+			resolver_.reset();
+			if (fd_ >= 0) {
+				::close(fd_);
+			}
+		}
+
+		NetworkSink(const NetworkSink&) = delete;
+		NetworkSink& operator=(const NetworkSink&) = delete;
+
+		void write(const LogEntry& entry) override {
+			write_batch(&entry, 1);
+		}
+
+		void write_batch(const LogEntry* entries, size_t count) override {
+			auto now = std::chrono::steady_clock::now();
+
+			if (protocol_ == Protocol::Udp) {
+				for (size_t i = 0; i < count; ++i) {
+					build_message(entries[i]);
+					send_datagram(now);
+				}
+				return;
+			}
+
+			for (size_t i = 0; i < count; ++i) {
+				build_message(entries[i]);
+				std::string length = std::to_string(message_.size());
+				size_t frame = length.size() + 1 + message_.size();
+				if (buffer_.size() - head_ + frame > options_.max_buffer) {
+					drop(1);
+					continue;
+				}
+				buffer_ += length;
+				buffer_ += ' ';
+				buffer_ += message_;
+				frames_.push_back(frame);
+			}
+			send_buffered(now);
+		}
+
+		// 블로킹하지 않으므로 남은 데이터는 다음 write/flush에서 이어서 보낸다
+		void flush() override {
+			if (protocol_ == Protocol::Tcp) {
+				send_buffered(std::chrono::steady_clock::now());
+			}
+		}
+
+		void collect_stats(SinkStats& stats) const override {
+			stats.bytes_sent += bytes_sent_.load(std::memory_order_relaxed);
+			stats.dropped += dropped_.load(std::memory_order_relaxed);
+		}
+
+		uint64_t bytes_sent() const {
+			return bytes_sent_.load(std::memory_order_relaxed);
+		}
+
+		uint64_t dropped() const {
+			return dropped_.load(std::memory_order_relaxed);
+		}
+	};
+#endif
+
+#if !defined(_WIN32)
+	namespace detail {
+
+		// 여러 프로세스가 공유하는 고정 크기 슬롯 링 (shm_open + mmap, SharedMemorySink / SharedMemoryCollector)
+		// 생산자는 RingBuffer와 같은 시퀀스 방식으로 슬롯을 잡아 직접 기록하고, 수집기 하나가 순서대로 꺼낸다.
+		// 세그먼트는 먼저 연 프로세스가 만들고 unlink하기 전까지 남는다. 그래서 수집기가 죽어도 생산자는 계속 기록하고,
+		// 다시 뜬 수집기는 남아 있는 dequeue 위치부터 이어서 읽는다. 가득 차면 생산자는 기다리지 않고 새 항목을 버린다.
+		class SharedRing {
+		public:
+			static constexpr uint64_t kMagic = 0x3151474f4c505043ULL;  // "CPPLOGQ1"
+			static constexpr uint32_t kVersion = 1;
+
+			struct alignas(64) Header {
+				std::atomic<uint64_t> magic;                    // 만든 프로세스가 초기화를 마친 뒤 마지막에 기록
+				uint32_t version;
+				uint32_t slot_size;
+				uint64_t slot_count;
+				alignas(64) std::atomic<uint64_t> enqueue_pos;
+				alignas(64) std::atomic<uint64_t> dequeue_pos;
+				alignas(64) std::atomic<uint64_t> dropped;      // 가득 차서 버린 항목
+				std::atomic<uint64_t> truncated;                // 슬롯보다 길어 잘린 메시지
+				std::atomic<uint64_t> abandoned;                // 생산자가 잡은 뒤 끝내지 못한 슬롯 (기록 중 종료)
+				std::atomic<uint64_t> stalled;                  // 살아 있는 생산자를 1초 넘게 기다린 슬롯
+				std::atomic<int32_t> collector_pid;
+			};
+
+			struct Slot {
+				std::atomic<uint64_t> sequence;
+				std::atomic<int32_t> writer_pid;
+				uint32_t size;
+				// 이어서 slot_size - sizeof(Slot) 바이트의 레코드
+			};
+
+			static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared ring needs address-free 64-bit atomics");
+
+			SharedRing() = default;
+
+			~SharedRing() {
+				close();
+			}
+
+			SharedRing(const SharedRing&) = delete;
+			SharedRing& operator=(const SharedRing&) = delete;
+
+			// name이 '/'로 시작하지 않으면 붙인다. 이미 있는 링에 붙으면 그 링의 크기를 그대로 쓴다.
+			// 실패하면 false와 이유 (error)
+			bool open(const std::string& name, size_t slot_size, size_t slot_count, std::string& error) {
+				close();
+				std::string path = shm_path(name);
+
+				bool created = true;
+				int fd = ::shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0660);
+				if (fd < 0 && errno == EEXIST) {
+					created = false;
+					fd = ::shm_open(path.c_str(), O_RDWR | O_CLOEXEC, 0660);
+				}
+				if (fd < 0) {
+					error = path + ": " + std::strerror(errno);
+					return false;
+				}
+
+				if (created) {
+					slot_size = (std::max)((slot_size + 63) / 64 * 64, static_cast<size_t>(128));
+					size_t count = 2;
+					while (count < slot_count) count <<= 1;
+					size_t total = sizeof(Header) + slot_size * count;
+					void* mapping = ::ftruncate(fd, static_cast<off_t>(total)) == 0
+						? ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+						: MAP_FAILED;
+					if (mapping == MAP_FAILED) {
+						error = path + ": " + std::strerror(errno);
+						::close(fd);
+						::shm_unlink(path.c_str());
+						return false;
+					}
+
+					header_ = new (mapping) Header();
+					header_->version = kVersion;
+					header_->slot_size = static_cast<uint32_t>(slot_size);
+					header_->slot_count = count;
+					attach(fd, mapping, total);
+					for (uint64_t i = 0; i < count; ++i) {
+						Slot* entry = new (slot(i)) Slot();
+						entry->sequence.store(i, std::memory_order_relaxed);
+					}
+					header_->magic.store(kMagic, std::memory_order_release);
+					return true;
+				}
+
+				// 다른 프로세스가 만드는 중이면 초기화가 끝날 때까지 잠시 기다린다
+				auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+				for (;;) {
+					struct stat st;
+					if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(Header)) {
+						void* mapping = ::mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, fd, 0);
+						if (mapping != MAP_FAILED) {
+							const Header* header = static_cast<const Header*>(mapping);
+							bool ready = header->magic.load(std::memory_order_acquire) == kMagic;
+							uint32_t version = header->version;
+							size_t total = sizeof(Header) + static_cast<size_t>(header->slot_size) * header->slot_count;
+							::munmap(mapping, sizeof(Header));
+
+							if (ready && version != kVersion) {
+								error = path + ": unsupported ring version";
+								::close(fd);
+								return false;
+							}
+							if (ready && static_cast<size_t>(st.st_size) >= total) {
+								mapping = ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+								if (mapping == MAP_FAILED) {
+									error = path + ": " + std::strerror(errno);
+									::close(fd);
+									return false;
+								}
+								header_ = static_cast<Header*>(mapping);
+								attach(fd, mapping, total);
+								return true;
+							}
+						}
+					}
+
+					if (std::chrono::steady_clock::now() >= deadline) {
+						error = path + ": ring was never initialized";
+						::close(fd);
+						return false;
+					}
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+			}
+
+			void close() {
+				if (mapping_) {
+					::munmap(mapping_, mapping_size_);
+					::close(fd_);
+				}
+				mapping_ = nullptr;
+				header_ = nullptr;
+				fd_ = -1;
+			}
+
+			static bool unlink(const std::string& name) {
+				return ::shm_unlink(shm_path(name).c_str()) == 0;
+			}
+
+			bool is_open() const {
+				return header_ != nullptr;
+			}
+
+			Header& header() const {
+				return *header_;
+			}
+
+			size_t payload_capacity() const {
+				return header_->slot_size - sizeof(Slot);
+			}
+
+			// 생산자: 빈 슬롯 하나를 잡아 기록할 위치를 돌려준다 (가득 차면 nullptr, 버린 개수를 센다)
+			char* claim(uint64_t& pos, int32_t pid) {
+				pos = header_->enqueue_pos.load(std::memory_order_relaxed);
+				for (;;) {
+					Slot* entry = slot(pos);
+					uint64_t sequence = entry->sequence.load(std::memory_order_acquire);
+					auto diff = static_cast<int64_t>(sequence - pos);
+					if (diff == 0) {
+						if (header_->enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+							entry->writer_pid.store(pid, std::memory_order_relaxed);
+							return payload(entry);
+						}
+					}
+					else if (diff < 0) {
+						header_->dropped.fetch_add(1, std::memory_order_relaxed);
+						return nullptr;
+					}
+					else {
+						pos = header_->enqueue_pos.load(std::memory_order_relaxed);
+					}
+				}
+			}
+
+			// 생산자: 기록을 마친 슬롯을 수집기에 보인다 (수집기가 이미 버린 슬롯이면 false)
+			bool publish(uint64_t pos, size_t size) {
+				Slot* entry = slot(pos);
+				entry->size = static_cast<uint32_t>(size);
+				uint64_t expected = pos;
+				return entry->sequence.compare_exchange_strong(expected, pos + 1, std::memory_order_release, std::memory_order_relaxed);
+			}
+
+			// 수집기: 다음 레코드가 있으면 fn(data, size)로 넘기고 true (빈 링이면 false)
+			// 이전 수집기가 꺼낸 직후 위치를 옮기기 전에 죽었으면 그 슬롯은 건너뛴다. 생산자가 잡은 채로
+			// 1초 넘게 끝내지 못한 슬롯은 그 프로세스가 없을 때만 버린다 (기록 중 종료한 생산자).
+			// 살아 있는 생산자의 슬롯을 재사용하면 늦게 끝난 memcpy가 다음 바퀴의 레코드를 덮어쓰므로,
+			// 그때는 stalled로 한 번 세고 계속 기다린다. pid를 아직 기록하지 못한 슬롯(0)도 기다린다.
+			template<typename Fn>
+			bool pop(Fn&& fn) {
+				uint64_t count = header_->slot_count;
+				uint64_t pos = header_->dequeue_pos.load(std::memory_order_relaxed);
+				Slot* entry = slot(pos);
+				uint64_t sequence = entry->sequence.load(std::memory_order_acquire);
+
+				if (sequence == pos + 1) {
+					fn(static_cast<const char*>(payload(entry)), (std::min)(static_cast<size_t>(entry->size), payload_capacity()));
+					entry->writer_pid.store(0, std::memory_order_relaxed);  // 다음 바퀴의 생산자가 다시 기록
+					entry->sequence.store(pos + count, std::memory_order_release);
+					header_->dequeue_pos.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+
+				if (sequence == pos + count) {
+					header_->dequeue_pos.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+
+				if (sequence != pos || header_->enqueue_pos.load(std::memory_order_acquire) == pos) {
+					return false;
+				}
+
+				auto now = std::chrono::steady_clock::now();
+				if (stuck_pos_ != pos) {
+					stuck_pos_ = pos;
+					stuck_since_ = now;
+					stuck_counted_ = false;
+					return false;
+				}
+				if (now - stuck_since_ < std::chrono::seconds(1)) {
+					return false;
+				}
+
+				int32_t writer = entry->writer_pid.load(std::memory_order_acquire);
+				bool gone = writer > 0 && ::kill(writer, 0) != 0 && errno == ESRCH;
+				if (!gone) {
+					if (!stuck_counted_) {
+						stuck_counted_ = true;
+						header_->stalled.fetch_add(1, std::memory_order_relaxed);
+					}
+					return false;
+				}
+
+				// CAS가 성공하면 바로 다음 바퀴의 생산자가 pid를 쓸 수 있으므로 그 전에 지운다
+				entry->writer_pid.store(0, std::memory_order_relaxed);
+				if (entry->sequence.compare_exchange_strong(sequence, pos + count, std::memory_order_acq_rel)) {
+					header_->abandoned.fetch_add(1, std::memory_order_relaxed);
+					header_->dequeue_pos.store(pos + 1, std::memory_order_release);
+				}
+				return true;
+			}
+
+			uint64_t backlog() const {
+				return header_->enqueue_pos.load(std::memory_order_relaxed) - header_->dequeue_pos.load(std::memory_order_relaxed);
+			}
+
+		private:
+			Header* header_ = nullptr;
+			void* mapping_ = nullptr;
+			size_t mapping_size_ = 0;
+			int fd_ = -1;
+			uint64_t stuck_pos_ = ~uint64_t(0);
+			std::chrono::steady_clock::time_point stuck_since_;
+			bool stuck_counted_ = false;
+
+			static std::string shm_path(const std::string& name) {
+				return !name.empty() && name[0] == '/' ? name : "/" + name;
+			}
+
+			void attach(int fd, void* mapping, size_t size) {
+				fd_ = fd;
+				mapping_ = mapping;
+				mapping_size_ = size;
+			}
+
+			Slot* slot(uint64_t pos) const {
+				char* base = static_cast<char*>(mapping_) + sizeof(Header);
+				return reinterpret_cast<Slot*>(base + (pos & (header_->slot_count - 1)) * header_->slot_size);
+			}
+
+			static char* payload(Slot* entry) {
+				return reinterpret_cast<char*>(entry) + sizeof(Slot);
+			}
+		};
+
+		// 슬롯 하나에 담는 레코드: 이 헤더 + 스레드 텍스트 + 로거 이름 + 구조화 필드 바이트 + 메시지
+		// 슬롯에 다 들어가지 않으면 필드를 빼고, 그래도 넘치면 메시지를 자른다 (flags에 표시).
+		struct SharedRecord {
+			static constexpr uint8_t kTruncated = 1;
+
+			int64_t timestamp_ns;
+			uint32_t pid;
+			uint8_t level;
+			uint8_t thread_size;
+			uint8_t name_size;
+			uint8_t flags;
+			uint16_t field_count;
+			uint16_t field_bytes;
+			uint32_t message_size;
+		};
+
+		// 기록한 바이트 수를 반환
+		inline size_t encode_shared_record(char* out, size_t capacity, const LogEntry& entry,
+			std::string_view thread, uint32_t pid) {
+			SharedRecord record{};
+			record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(entry.timestamp.time_since_epoch()).count();
+			record.pid = pid;
+			record.level = static_cast<uint8_t>(entry.level);
+
+			std::string_view name = entry.logger_name ? std::string_view(entry.logger_name) : std::string_view();
+			size_t room = capacity - sizeof(SharedRecord);
+			record.thread_size = static_cast<uint8_t>((std::min)({ thread.size(), room, static_cast<size_t>(255) }));
+			room -= record.thread_size;
+			record.name_size = static_cast<uint8_t>((std::min)({ name.size(), room, static_cast<size_t>(255) }));
+			room -= record.name_size;
+			if (entry.field_bytes <= room) {
+				record.field_count = entry.field_count;
+				record.field_bytes = entry.field_bytes;
+				room -= entry.field_bytes;
+			}
+
+			std::string_view message = entry.message.view();
+			record.message_size = static_cast<uint32_t>((std::min)(message.size(), room));
+			if (record.message_size < message.size() || record.field_bytes < entry.field_bytes) {
+				record.flags |= SharedRecord::kTruncated;
+			}
+
+			char* cursor = out;
+			std::memcpy(cursor, &record, sizeof(record));
+			cursor += sizeof(record);
+			std::memcpy(cursor, thread.data(), record.thread_size);
+			cursor += record.thread_size;
+			std::memcpy(cursor, name.data(), record.name_size);
+			cursor += record.name_size;
+			std::memcpy(cursor, entry.fields_data(), record.field_bytes);
+			cursor += record.field_bytes;
+			std::memcpy(cursor, message.data(), record.message_size);
+			cursor += record.message_size;
+			return static_cast<size_t>(cursor - out);
+		}
+
+	} // namespace detail
+
+	// 공유 메모리 링으로 보내는 싱크 (POSIX 전용, 같은 호스트의 log_collector / SharedMemoryCollector가 받는다)
+	// 워커가 항목을 슬롯에 바로 직렬화하므로 이 프로세스에는 파일과 로테이션이 없다. 링이 가득 차거나 수집기가
+	// 없어도 기다리지 않는다 (링이 빌 때까지 새 항목을 버리고 dropped로 센다). 링을 만들거나 붙지 못하면
+	// 아무것도 보내지 않으며 is_open() / error()로 확인할 수 있다.
+	class SharedMemorySink : public LogSink {
+	private:
+		detail::SharedRing ring_;
+		std::string error_;
+		detail::ThreadIdCache thread_ids_;
+		int32_t pid_;
+		std::atomic<uint64_t> bytes_{ 0 };
+		std::atomic<uint64_t> dropped_{ 0 };
+
+	public:
+		static constexpr size_t kDefaultSlotSize = 512;
+		static constexpr size_t kDefaultSlotCount = 16384;
+
+		// 링 크기는 처음 만드는 프로세스의 값이 쓰인다 (수집기와 같은 값을 주는 것이 좋다)
+		explicit SharedMemorySink(const std::string& name,
+			size_t slot_size = kDefaultSlotSize,
+			size_t slot_count = kDefaultSlotCount)
+			: pid_(static_cast<int32_t>(::getpid())) {
+			ring_.open(name, slot_size, slot_count, error_);
+		}
+
+		void write(const LogEntry& entry) override {
+			write_batch(&entry, 1);
+		}
+
+		void write_batch(const LogEntry* entries, size_t count) override {
+			if (!ring_.is_open()) return;
+
+			uint64_t bytes = 0;
+			uint64_t dropped = 0;
+			size_t truncated = 0;
+			for (size_t i = 0; i < count; ++i) {
+				uint64_t pos = 0;
+				char* out = ring_.claim(pos, pid_);
+				if (!out) {
+					++dropped;
+					continue;
+				}
+
+				size_t size = detail::encode_shared_record(out, ring_.payload_capacity(), entries[i],
+					thread_ids_.text(entries[i].thread_id), static_cast<uint32_t>(pid_));
+				if (reinterpret_cast<const detail::SharedRecord*>(out)->flags & detail::SharedRecord::kTruncated) {
+					++truncated;
+				}
+				if (ring_.publish(pos, size)) {
+					bytes += size;
+				}
+				else {
+					++dropped;
+				}
+			}
+
+			if (truncated > 0) {
+				ring_.header().truncated.fetch_add(truncated, std::memory_order_relaxed);
+			}
+			bytes_.store(bytes_.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+			dropped_.store(dropped_.load(std::memory_order_relaxed) + dropped, std::memory_order_relaxed);
+		}
+
+		// 슬롯에 쓴 내용은 바로 수집기에 보이므로 할 일이 없다
+		void flush() override {}
+
+		void collect_stats(SinkStats& stats) const override {
+			stats.bytes_sent = bytes_.load(std::memory_order_relaxed);
+			stats.dropped = dropped_.load(std::memory_order_relaxed);
+		}
+
+		bool is_open() const {
+			return ring_.is_open();
+		}
+
+		const std::string& error() const {
+			return error_;
+		}
+	};
+#endif
+
+	namespace detail {
+
+		// 이름 있는 로거의 계층 노드 ("net.rpc"의 부모는 "net")
+		// Logger가 소멸할 때까지 해제하지 않으므로 핸들과 LogEntry가 포인터를 그대로 보관한다.
+		struct LoggerNode {
+			std::string name;
+			LoggerNode* parent = nullptr;             // nullptr이면 루트(Logger 기본 레벨)를 따른다
+			int configured = -1;                      // 직접 지정한 레벨, -1이면 상속 (레지스트리 mutex 보호)
+			std::atomic<LogLevel> effective{ LogLevel::DEBUG };
+		};
+
+		// 레벨이 바뀌면 모든 노드의 유효 레벨을 다시 계산해 밀어 넣는다
+		// 변경은 드물고 잠금 안에서 처리되며, 로깅 경로는 노드의 effective를 한 번 읽기만 한다.
+		class LoggerRegistry {
+		private:
+			std::mutex mutex_;
+			std::unordered_map<std::string, std::unique_ptr<LoggerNode>> nodes_;
+			LogLevel root_level_ = LogLevel::DEBUG;
+
+			LogLevel resolve(const LoggerNode* node) const {
+				for (; node; node = node->parent) {
+					if (node->configured >= 0) {
+						return static_cast<LogLevel>(node->configured);
+					}
+				}
+				return root_level_;
+			}
+
+			void refresh() {
+				for (auto& item : nodes_) {
+					item.second->effective.store(resolve(item.second.get()), std::memory_order_relaxed);
+				}
+			}
+
+			// 없으면 상위 노드까지 함께 만든다
+			LoggerNode* find_or_create(const std::string& name) {
+				auto found = nodes_.find(name);
+				if (found != nodes_.end()) {
+					return found->second.get();
+				}
+
+				LoggerNode* parent = nullptr;
+				size_t dot = name.rfind('.');
+				if (dot != std::string::npos && dot > 0) {
+					parent = find_or_create(name.substr(0, dot));
+				}
+
+				auto node = std::make_unique<LoggerNode>();
+				node->name = name;
+				node->parent = parent;
+				node->effective.store(resolve(parent), std::memory_order_relaxed);
+				return nodes_.emplace(name, std::move(node)).first->second.get();
+			}
+
+		public:
+			LoggerNode* get(const std::string& name) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				return find_or_create(name);
+			}
+
+			// level이 -1이면 지정을 지우고 부모 레벨을 상속
+			void configure(const std::string& name, int level) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				find_or_create(name)->configured = level;
+				refresh();
+			}
+
+			// 기본 로거 레벨(root)도 같은 잠금 안에서 바꿔 노드와 어긋나지 않게 한다
+			void set_root_level(std::atomic<LogLevel>& root, LogLevel level) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				root.store(level, std::memory_order_relaxed);
+				root_level_ = level;
+				refresh();
+			}
+		};
+
+	} // namespace detail
+
+	namespace detail {
+
+		inline int highest_bit(uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+			unsigned long index;
+			_BitScanReverse64(&index, value);
+			return static_cast<int>(index);
+#elif defined(_MSC_VER)
+			int index = 0;
+			while (value >>= 1) ++index;
+			return index;
+#else
+			return 63 - __builtin_clzll(value);
+#endif
+		}
+
+		// HDR 스타일 로그-선형 지연 히스토그램 (나노초)
+		// 16ns 미만은 1ns 단위, 그 위로는 2의 거듭제곱 구간마다 16칸이라 상대 오차가 약 6%다.
+		// 기록은 소유 스레드만 하고 집계 스레드는 exchange로 칸을 비우며 읽는다.
+		struct LatencyHistogram {
+			static constexpr int kSubBits = 4;
+			static constexpr uint64_t kSubCount = uint64_t(1) << kSubBits;
+			static constexpr int kMaxBits = 40;   // 약 18분까지, 그 이상은 마지막 칸
+			static constexpr size_t kBucketCount = (kMaxBits - kSubBits + 1) * kSubCount;
+
+			std::array<std::atomic<uint64_t>, kBucketCount> buckets{};
+			std::atomic<uint64_t> max{ 0 };
+			std::atomic<bool> retired{ false };   // 소유 스레드가 종료됨
+
+			static size_t bucket_index(uint64_t ns) {
+				ns = (std::min)(ns, (uint64_t(1) << kMaxBits) - 1);
+				if (ns < kSubCount) {
+					return static_cast<size_t>(ns);
+				}
+				int shift = highest_bit(ns) - kSubBits;
+				return static_cast<size_t>((shift + 1) * kSubCount + ((ns >> shift) - kSubCount));
+			}
+
+			// 칸에 들어가는 가장 큰 값
+			static uint64_t bucket_upper(size_t index) {
+				if (index < kSubCount) {
+					return index;
+				}
+				int shift = static_cast<int>(index / kSubCount) - 1;
+				uint64_t sub = index % kSubCount + kSubCount;
+				return ((sub + 1) << shift) - 1;
+			}
+
+			void record(uint64_t ns) {
+				buckets[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+				if (ns > max.load(std::memory_order_relaxed)) {
+					max.store(ns, std::memory_order_relaxed);
+				}
+			}
+		};
+
+		// 칸별 개수에서 fraction 분위의 값 (칸의 상한)
+		inline uint64_t histogram_percentile(const std::vector<uint64_t>& counts, uint64_t total, double fraction) {
+			uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(total) + 0.5);
+			rank = (std::max)(rank, static_cast<uint64_t>(1));
+			uint64_t seen = 0;
+			for (size_t i = 0; i < counts.size(); ++i) {
+				seen += counts[i];
+				if (seen >= rank) {
+					return LatencyHistogram::bucket_upper(i);
+				}
+			}
+			return 0;
+		}
+
+		// LOG_PROFILE 호출 위치마다 하나씩 생기는 정적 정보
+		struct ProfileSite {
+			const char* name;
+		};
+
+		// 한 집계 구간의 이름별 요약
+		struct ProfileSummary {
+			std::string name;
+			uint64_t count = 0;
+			uint64_t p50 = 0;
+			uint64_t p99 = 0;
+			uint64_t max = 0;
+		};
+
+		// 스레드별 히스토그램 목록 (프로세스 전역)
+		// 스레드가 끝난 히스토그램은 마지막으로 집계한 뒤 목록에서 뺀다.
+		class ProfileRegistry {
+		private:
+			struct Slot {
+				const ProfileSite* site;
+				std::shared_ptr<LatencyHistogram> histogram;
+			};
+
+			std::mutex mutex_;
+			std::vector<Slot> slots_;
+
+		public:
+			static ProfileRegistry& instance() {
+				static ProfileRegistry* registry = new ProfileRegistry();
+				return *registry;
+			}
+
+			std::shared_ptr<LatencyHistogram> add(const ProfileSite& site) {
+				auto histogram = std::make_shared<LatencyHistogram>();
+				std::lock_guard<std::mutex> lock(mutex_);
+				slots_.push_back({ &site, histogram });
+				return histogram;
+			}
+
+			// 지난 집계 이후의 기록을 이름별로 합쳐 요약하고 히스토그램을 비운다
+			std::vector<ProfileSummary> collect() {
+				struct Merged {
+					std::vector<uint64_t> counts = std::vector<uint64_t>(LatencyHistogram::kBucketCount);
+					uint64_t total = 0;
+					uint64_t max = 0;
+				};
+				std::vector<std::pair<std::string_view, Merged>> merged;
+
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					for (size_t i = 0; i < slots_.size();) {
+						auto& slot = slots_[i];
+						bool retired = slot.histogram->retired.load(std::memory_order_acquire);
+
+						std::string_view name(slot.site->name);
+						auto found = std::find_if(merged.begin(), merged.end(),
+							[name](const auto& item) { return item.first == name; });
+						if (found == merged.end()) {
+							merged.emplace_back(name, Merged());
+							found = merged.end() - 1;
+						}
+
+						Merged& target = found->second;
+						for (size_t b = 0; b < LatencyHistogram::kBucketCount; ++b) {
+							uint64_t count = slot.histogram->buckets[b].exchange(0, std::memory_order_relaxed);
+							target.counts[b] += count;
+							target.total += count;
+						}
+						target.max = (std::max)(target.max, slot.histogram->max.exchange(0, std::memory_order_relaxed));
+
+						if (retired) {
+							slots_[i] = std::move(slots_.back());
+							slots_.pop_back();
+						}
+						else {
+							++i;
+						}
+					}
+				}
+
+				std::vector<ProfileSummary> summaries;
+				for (const auto& item : merged) {
+					const Merged& m = item.second;
+					if (m.total == 0) continue;
+
+					ProfileSummary summary;
+					summary.name = std::string(item.first);
+					summary.count = m.total;
+					summary.max = m.max;
+					summary.p50 = (std::min)(histogram_percentile(m.counts, m.total, 0.50), m.max);
+					summary.p99 = (std::min)(histogram_percentile(m.counts, m.total, 0.99), m.max);
+					summaries.push_back(std::move(summary));
+				}
+				std::sort(summaries.begin(), summaries.end(),
+					[](const ProfileSummary& lhs, const ProfileSummary& rhs) { return lhs.name < rhs.name; });
+				return summaries;
+			}
+		};
+
+		// 호출 위치별 thread_local 히스토그램 (LOG_PROFILE 매크로가 만든다)
+		struct ThreadHistogram {
+			std::shared_ptr<LatencyHistogram> histogram;
+
+			explicit ThreadHistogram(const ProfileSite& site) : histogram(ProfileRegistry::instance().add(site)) {}
+
+			~ThreadHistogram() {
+				histogram->retired.store(true, std::memory_order_release);
+			}
+		};
+
+		// 스레드마다 다른 캐시 라인에 더하는 카운터 (생산자끼리 같은 줄을 두고 경쟁하지 않도록)
+		class StripedCounter {
+		private:
+			static constexpr size_t kStripes = 16;
+
+			struct alignas(64) Stripe {
+				std::atomic<uint64_t> value{ 0 };
+			};
+
+			std::array<Stripe, kStripes> stripes_;
+
+			static size_t stripe_index() {
+				static std::atomic<size_t> next{ 0 };
+				thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed) % kStripes;
+				return index;
+			}
+
+		public:
+			void add(uint64_t value) {
+				stripes_[stripe_index()].value.fetch_add(value, std::memory_order_relaxed);
+			}
+
+			uint64_t load() const {
+				uint64_t total = 0;
+				for (const auto& stripe : stripes_) {
+					total += stripe.value.load(std::memory_order_relaxed);
+				}
+				return total;
+			}
+		};
+
+		// 싱크 하나의 누적 통계 (그 싱크를 맡은 워커만 갱신하고 stats()가 읽는다)
+		struct SinkCounters {
+			std::atomic<uint64_t> entries{ 0 };
+			std::atomic<uint64_t> writes{ 0 };
+			std::atomic<uint64_t> write_ns{ 0 };
+			std::atomic<uint64_t> flushes{ 0 };
+			std::atomic<uint64_t> flush_ns{ 0 };
+			std::atomic<uint64_t> errors{ 0 };
+
+			static void bump(std::atomic<uint64_t>& counter, uint64_t value) {
+				counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+			}
+		};
+
+		// 에포크 기반 회수: 읽는 쪽은 구간 동안 시작 시점의 에포크를 걸어 두고(pinned), 스냅샷을 교체한 쪽은
+		// 에포크를 올린 뒤 그 전에 시작된 구간이 모두 끝날 때까지 기다렸다가 이전 스냅샷을 지운다.
+		// 읽기 구간 진입은 원자 저장 한 번이며 락이 없다 (교체는 드물고 기다리는 쪽이 비용을 낸다).
+		struct EpochReader {
+			std::atomic<uint64_t> pinned{ 0 };   // 0이면 구간 밖
+		};
+
+		class EpochDomain {
+		public:
+			class Guard {
+			public:
+				Guard(EpochDomain& domain, EpochReader& reader) : reader_(reader) {
+					reader_.pinned.store(domain.epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+				}
+
+				~Guard() {
+					reader_.pinned.store(0, std::memory_order_release);
+				}
+
+				Guard(const Guard&) = delete;
+				Guard& operator=(const Guard&) = delete;
+
+			private:
+				EpochReader& reader_;
+			};
+
+			// 스냅샷을 교체한 뒤 호출: 교체 전에 구간에 들어간 읽기가 끝날 때까지 대기
+			template<typename Readers>
+			void synchronize(const Readers& readers) {
+				uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+				for (const EpochReader* reader : readers) {
+					for (;;) {
+						uint64_t pinned = reader->pinned.load(std::memory_order_seq_cst);
+						if (pinned == 0 || pinned >= epoch) break;
+						std::this_thread::yield();
+					}
+				}
+			}
+
+		private:
+			std::atomic<uint64_t> epoch_{ 1 };
+		};
+
+		inline uint64_t elapsed_ns(std::chrono::steady_clock::time_point since) {
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - since).count());
+		}
+
+		// 850ns, 12.3us, 4.56ms, 1.20s 형태
+		inline void append_duration(std::ostream& os, uint64_t ns) {
+			char buffer[32];
+			if (ns < 1000) {
+				std::snprintf(buffer, sizeof(buffer), "%lluns", static_cast<unsigned long long>(ns));
+			}
+			else if (ns < 1000000) {
+				std::snprintf(buffer, sizeof(buffer), "%.1fus", static_cast<double>(ns) / 1e3);
+			}
+			else if (ns < 1000000000) {
+				std::snprintf(buffer, sizeof(buffer), "%.2fms", static_cast<double>(ns) / 1e6);
+			}
+			else {
+				std::snprintf(buffer, sizeof(buffer), "%.2fs", static_cast<double>(ns) / 1e9);
+			}
+			os << buffer;
+		}
+
+	} // namespace detail
+
+	// 구간 시간만 스레드별 히스토그램에 기록하는 프로파일 스코프 (LOG_PROFILE)
+	// 호출마다 로그를 남기지 않고, 워커가 주기적으로 이름별 p50/p99/max 요약을 출력한다.
+	class ProfileScope {
+	private:
+		detail::LatencyHistogram& histogram_;
+		std::chrono::steady_clock::time_point start_;
+
+	public:
+		explicit ProfileScope(detail::LatencyHistogram& histogram)
+			: histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+		~ProfileScope() {
+			auto elapsed = std::chrono::steady_clock::now() - start_;
+			histogram_.record(static_cast<uint64_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+	};
+
+	namespace detail {
+
+		// 플라이트 레코더 항목 하나 (128바이트): 포맷하지 않고 포맷 포인터와 지연 포맷 인자 바이트만 남긴다
+		struct FlightRecord {
+			enum Kind : uint8_t { Packed, Literal, Text, PartialText, PackedText };
+			static constexpr size_t kDataSize = 92;
+
+			int64_t timestamp_ns;
+			const char* format;        // LOG_* 매크로의 포맷 리터럴 (사본을 쓰는 종류면 nullptr)
+			const char* arg_types;     // Packed/PackedText일 때 지연 포맷 타입 시그니처
+			const char* logger_name;
+			uint16_t size;
+			uint8_t level;
+			uint8_t kind;              // Literal/PartialText: 인자를 담지 못함, Text: 포맷 문자열 사본, PackedText: 포맷 사본 + '\0' + 인자 바이트
+			unsigned char data[kDataSize];
+		};
+
+		static_assert(sizeof(FlightRecord) == 128, "FlightRecord should stay two cache lines");
+
+		// 스레드별 고정 크기 링 (해당 스레드만 쓰고, 덤프는 head 이전의 항목만 읽는다)
+		struct FlightRing {
+			std::unique_ptr<FlightRecord[]> records;
+			size_t capacity;
+			std::atomic<uint64_t> head{ 0 };
+			std::atomic<bool> owned{ true };
+			char thread_text[32] = {};
+
+			explicit FlightRing(size_t entries) : records(new FlightRecord[entries]), capacity(entries) {}
+		};
+
+		// 신호 처리기에서 쓰는 버퍼 출력 (write(2)만 사용, 메모리 할당 없음)
+		class SignalSafeWriter {
+		private:
+			int fd_;
+			char buffer_[4096];
+			size_t used_ = 0;
+
+		public:
+			explicit SignalSafeWriter(int fd) : fd_(fd) {}
+			~SignalSafeWriter() { flush(); }
+
+			SignalSafeWriter(const SignalSafeWriter&) = delete;
+			SignalSafeWriter& operator=(const SignalSafeWriter&) = delete;
+
+			void flush() {
+				size_t offset = 0;
+				while (offset < used_) {
+#if defined(_WIN32)
+					int written = _write(fd_, buffer_ + offset, static_cast<unsigned int>(used_ - offset));
+#else
+					ssize_t written = ::write(fd_, buffer_ + offset, used_ - offset);
+					if (written < 0 && errno == EINTR) continue;
+#endif
+					if (written <= 0) break;
+					offset += static_cast<size_t>(written);
+				}
+				used_ = 0;
+			}
+
+			void append(const char* text, size_t size) {
+				while (size > 0) {
+					if (used_ == sizeof(buffer_)) flush();
+					size_t chunk = (std::min)(size, sizeof(buffer_) - used_);
+					std::memcpy(buffer_ + used_, text, chunk);
+					used_ += chunk;
+					text += chunk;
+					size -= chunk;
+				}
+			}
+
+			void append(std::string_view text) { append(text.data(), text.size()); }
+			void append(char c) { append(&c, 1); }
+
+			template<typename T>
+			void append_number(T value) {
+				char text[kNumberTextSize];
+				append(text, number_to_chars(text, value));
+			}
+
+			// 고정 자릿수 0 채움 (타임스탬프용)
+			void append_padded(uint64_t value, int width) {
+				char text[20];
+				for (int i = width - 1; i >= 0; --i) {
+					text[i] = static_cast<char>('0' + value % 10);
+					value /= 10;
+				}
+				append(text, static_cast<size_t>(width));
+			}
+		};
+
+		// 1970-01-01부터의 일수를 연/월/일로 (localtime은 신호 처리기에서 쓸 수 없다)
+		inline void civil_from_days(int64_t days, int64_t& year, unsigned& month, unsigned& day) {
+			days += 719468;
+			int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+			auto doe = static_cast<unsigned>(days - era * 146097);
+			unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+			unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+			unsigned mp = (5 * doy + 2) / 153;
+			day = doy - (153 * mp + 2) / 5 + 1;
+			month = mp < 10 ? mp + 3 : mp - 9;
+			year = static_cast<int64_t>(yoe) + era * 400 + (month <= 2);
+		}
+
+		// 패킹된 인자 하나를 기록하고 소비한 바이트 수를 반환 (append_packed_arg의 신호 안전 버전)
+		inline size_t write_flight_arg(SignalSafeWriter& out, char type, const unsigned char* data, size_t size) {
+			switch (type) {
+			case 'i': if (size < 8) return 0; out.append_number(read_packed<int64_t>(data)); return 8;
+			case 'u': if (size < 8) return 0; out.append_number(read_packed<uint64_t>(data)); return 8;
+			case 'f': if (size < 4) return 0; out.append_number(read_packed<float>(data)); return 4;
+			case 'd': if (size < 8) return 0; out.append_number(read_packed<double>(data)); return 8;
+			case 'b': if (size < 1) return 0; out.append(data[0] ? '1' : '0'); return 1;
+			case 'c': if (size < 1) return 0; out.append(static_cast<char>(data[0])); return 1;
+			case 's': {
+				if (size < sizeof(uint32_t)) return 0;
+				auto length = read_packed<uint32_t>(data);
+				if (size - sizeof(uint32_t) < length) return 0;
+				out.append(reinterpret_cast<const char*>(data + sizeof(uint32_t)), length);
+				return sizeof(uint32_t) + length;
+			}
+			case 'p': {
+				if (size < 8) return 0;
+				char text[kNumberTextSize];
+				out.append("0x");
+				out.append(text, static_cast<size_t>(std::to_chars(text, text + sizeof(text), read_packed<uint64_t>(data), 16).ptr - text));
+				return 8;
+			}
+			default:
+				return 0;
+			}
+		}
+
+#if !defined(_WIN32)
+		// 치명적 신호 처리기가 쓰는 스레드별 대체 스택 (SA_ONSTACK)
+		// 스택이 넘쳐서 난 SIGSEGV도 다 쓴 스택 대신 여기서 덤프한다. CrashSignals::install을 부른 스레드와
+		// 그 뒤 플라이트 레코더 링을 만드는 스레드마다 하나씩 두고, 스레드가 끝나면 해제한다.
+		class AltSignalStack {
+		public:
+			static inline std::atomic<bool> enabled{ false };
+
+			static void ensure() {
+				struct Holder {
+					void* memory = nullptr;
+					~Holder() {
+						if (!memory) return;
+						stack_t current;
+						if (sigaltstack(nullptr, &current) == 0 && current.ss_sp == memory) {
+							stack_t off;
+							std::memset(&off, 0, sizeof(off));
+							off.ss_flags = SS_DISABLE;
+							sigaltstack(&off, nullptr);
+						}
+						std::free(memory);
+					}
+				};
+				static thread_local Holder holder;
+				if (holder.memory) return;
+
+				// 런타임이나 사용자가 이미 둔 대체 스택은 그대로 쓴다
+				stack_t current;
+				if (sigaltstack(nullptr, &current) == 0 && !(current.ss_flags & SS_DISABLE)) return;
+
+				size_t size = (std::max)(static_cast<size_t>(SIGSTKSZ), static_cast<size_t>(64 * 1024));
+				void* memory = std::malloc(size);
+				if (!memory) return;
+				stack_t stack;
+				std::memset(&stack, 0, sizeof(stack));
+				stack.ss_sp = memory;
+				stack.ss_size = size;
+				if (sigaltstack(&stack, nullptr) != 0) {
+					std::free(memory);
+					return;
+				}
+				holder.memory = memory;
+			}
+		};
+#endif
+
+		// 프로세스 전체의 플라이트 레코더 (신호 처리기에서 접근하므로 정적 배열만 쓴다)
+		// 스레드는 처음 기록할 때 링을 하나 잡고, 종료하면 반납한다. 반납된 링은 빈 슬롯이 없을 때만 재사용되므로
+		// 종료한 스레드의 마지막 기록도 가능한 한 오래 남는다.
+		class FlightRecorder {
+		public:
+			static constexpr int kDisabled = static_cast<int>(LogLevel::FATAL) + 1;
+			static constexpr size_t kMaxRings = 256;
+			static constexpr size_t kMaxPath = 4096;
+
+			static inline std::atomic<int> level{ kDisabled };
+			static inline std::atomic<size_t> entries_per_thread{ 256 };
+			static inline std::atomic<FlightRing*> rings[kMaxRings] = {};
+			static inline std::atomic<bool> dumping{ false };
+			static inline char path[kMaxPath] = {};
+
+			static bool records(LogLevel value) {
+				return static_cast<int>(value) >= level.load(std::memory_order_relaxed);
+			}
+
+			static FlightRing* local_ring() {
+				struct Handle {
+					FlightRing* ring = nullptr;
+					bool tried = false;
+					~Handle() {
+						if (ring) ring->owned.store(false, std::memory_order_release);
+					}
+				};
+				static thread_local Handle handle;
+				if (!handle.tried) {
+					handle.tried = true;
+					handle.ring = acquire_ring();
+#if !defined(_WIN32)
+					if (AltSignalStack::enabled.load(std::memory_order_acquire)) {
+						AltSignalStack::ensure();
+					}
+#endif
+				}
+				return handle.ring;
+			}
+
+			// 링 기록: next()로 받은 항목을 채우고 publish()
+			static FlightRecord& next(FlightRing& ring) {
+				return ring.records[ring.head.load(std::memory_order_relaxed) % ring.capacity];
+			}
+
+			static void publish(FlightRing& ring) {
+				ring.head.store(ring.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			}
+
+			// 모든 링을 시간순으로 합쳐 path 파일 끝에 덧붙인다 (async-signal-safe)
+			// 다른 덤프가 진행 중이면 false
+			static bool dump(const char* reason) {
+				if (path[0] == '\0' || dumping.exchange(true, std::memory_order_acquire)) return false;
+
+#if defined(_WIN32)
+				int fd = _open(path, _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+				int fd = ::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+				if (fd < 0) {
+					dumping.store(false, std::memory_order_release);
+					return false;
+				}
+
+				{
+					SignalSafeWriter out(fd);
+					out.append("==== flight recorder dump: ");
+					out.append(reason, std::strlen(reason));
+					out.append(" ====\n");
+					write_merged(out);
+				}
+#if defined(_WIN32)
+				_close(fd);
+#else
+				::close(fd);
+#endif
+				dumping.store(false, std::memory_order_release);
+				return true;
+			}
+
+		private:
+			static FlightRing* acquire_ring() {
+				// 빈 슬롯에 새 링을 만든다
+				for (auto& slot : rings) {
+					if (slot.load(std::memory_order_acquire) != nullptr) continue;
+					auto ring = std::make_unique<FlightRing>((std::max)(entries_per_thread.load(std::memory_order_relaxed), static_cast<size_t>(1)));
+					fill_thread_text(*ring);
+					FlightRing* expected = nullptr;
+					if (slot.compare_exchange_strong(expected, ring.get(), std::memory_order_acq_rel)) {
+						return ring.release();
+					}
+				}
+
+				// 모두 찼으면 종료한 스레드의 링을 비우고 재사용
+				for (auto& slot : rings) {
+					FlightRing* ring = slot.load(std::memory_order_acquire);
+					bool expected = false;
+					if (ring && ring->owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+						ring->head.store(0, std::memory_order_release);
+						fill_thread_text(*ring);
+						return ring;
+					}
+				}
+				return nullptr;
+			}
+
+			static void fill_thread_text(FlightRing& ring) {
+				std::ostringstream oss;
+				oss << std::this_thread::get_id();
+				std::string text = oss.str();
+				size_t size = (std::min)(text.size(), sizeof(ring.thread_text) - 1);
+				std::memcpy(ring.thread_text, text.data(), size);
+				ring.thread_text[size] = '\0';
+			}
+
+			static void write_merged(SignalSafeWriter& out) {
+				// 링마다 [begin, end) 구간: 쓰는 중일 수 있는 가장 오래된 칸 하나는 건너뛴다
+				uint64_t cursor[kMaxRings];
+				uint64_t end[kMaxRings];
+				for (size_t i = 0; i < kMaxRings; ++i) {
+					FlightRing* ring = rings[i].load(std::memory_order_acquire);
+					end[i] = ring ? ring->head.load(std::memory_order_acquire) : 0;
+					cursor[i] = ring && end[i] >= ring->capacity ? end[i] - ring->capacity + 1 : 0;
+				}
+
+				for (;;) {
+					size_t best = kMaxRings;
+					int64_t best_time = 0;
+					for (size_t i = 0; i < kMaxRings; ++i) {
+						if (cursor[i] >= end[i]) continue;
+						FlightRing* ring = rings[i].load(std::memory_order_relaxed);
+						int64_t time = ring->records[cursor[i] % ring->capacity].timestamp_ns;
+						if (best == kMaxRings || time < best_time) {
+							best = i;
+							best_time = time;
+						}
+					}
+					if (best == kMaxRings) break;
+
+					FlightRing* ring = rings[best].load(std::memory_order_relaxed);
+					write_record(out, ring->records[cursor[best]++ % ring->capacity], ring->thread_text);
+				}
+			}
+
+			// 2024-06-02T10:30:45.123456Z DEBUG [140234] net.rpc: 메시지
+			static void write_record(SignalSafeWriter& out, const FlightRecord& record, const char* thread_text) {
+				static const char* const kLevels[] = { "DEBUG", "INFO ", "WARN ", "ERROR", "FATAL" };
+
+				int64_t micros = record.timestamp_ns / 1000;
+				int64_t seconds = micros / 1000000;
+				int64_t days = seconds / 86400;
+				if (micros < 0) return;
+
+				int64_t year;
+				unsigned month, day;
+				civil_from_days(days, year, month, day);
+				uint64_t second_of_day = static_cast<uint64_t>(seconds % 86400);
+
+				out.append_padded(static_cast<uint64_t>(year), 4);
+				out.append('-');
+				out.append_padded(month, 2);
+				out.append('-');
+				out.append_padded(day, 2);
+				out.append('T');
+				out.append_padded(second_of_day / 3600, 2);
+				out.append(':');
+				out.append_padded(second_of_day / 60 % 60, 2);
+				out.append(':');
+				out.append_padded(second_of_day % 60, 2);
+				out.append('.');
+				out.append_padded(static_cast<uint64_t>(micros % 1000000), 6);
+				out.append("Z ");
+				out.append(record.level <= static_cast<uint8_t>(LogLevel::FATAL) ? kLevels[record.level] : "?????");
+				out.append(" [");
+				out.append(thread_text, std::strlen(thread_text));
+				out.append("] ");
+				if (record.logger_name && record.logger_name[0]) {
+					out.append(record.logger_name, std::strlen(record.logger_name));
+					out.append(": ");
+				}
+
+				size_t size = (std::min)(static_cast<size_t>(record.size), FlightRecord::kDataSize);
+				if (record.kind == FlightRecord::Text || record.kind == FlightRecord::PartialText) {
+					out.append(reinterpret_cast<const char*>(record.data), size);
+					if (record.kind == FlightRecord::PartialText) out.append(" [args not recorded]");
+				}
+				else if (record.kind == FlightRecord::Literal) {
+					out.append(record.format, std::strlen(record.format));
+					out.append(" [args not recorded]");
+				}
+				else {
+					// format_packed와 같은 규칙으로 {}를 치환 (PackedText는 data 앞쪽의 포맷 사본을 쓴다)
+					std::string_view format;
+					const unsigned char* data = record.data;
+					if (record.kind == FlightRecord::PackedText) {
+						const char* text = reinterpret_cast<const char*>(record.data);
+						size_t length = static_cast<size_t>(std::find(text, text + size, '\0') - text);
+						format = std::string_view(text, length);
+						size_t skip = (std::min)(length + 1, size);
+						data += skip;
+						size -= skip;
+					}
+					else {
+						format = std::string_view(record.format);
+					}
+					for (const char* type = record.arg_types; type && *type; ++type) {
+						size_t pos = format.find("{}");
+						if (pos == std::string_view::npos) break;
+						out.append(format.data(), pos);
+						size_t used = write_flight_arg(out, *type, data, size);
+						if (used == 0) {
+							out.append("[FORMAT_ERROR]");
+							size = 0;
+						}
+						data += used;
+						size -= used;
+						format.remove_prefix(pos + 2);
+					}
+					out.append(format);
+				}
+				out.append('\n');
+			}
+		};
+
+#if !defined(_WIN32)
+		// 치명적 신호에서 덤프한 뒤 원래 처리기로 되돌려 같은 신호를 다시 보낸다
+		class CrashSignals {
+		private:
+			static constexpr int kSignals[] = { SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL };
+			static inline struct sigaction previous_[5];
+			static inline std::atomic<bool> installed_{ false };
+
+			static const char* signal_name(int signal) {
+				switch (signal) {
+				case SIGSEGV: return "SIGSEGV";
+				case SIGABRT: return "SIGABRT";
+				case SIGBUS:  return "SIGBUS";
+				case SIGFPE:  return "SIGFPE";
+				case SIGILL:  return "SIGILL";
+				default:      return "signal";
+				}
+			}
+
+			static void handle(int signal) {
+				FlightRecorder::dump(signal_name(signal));
+				for (size_t i = 0; i < 5; ++i) {
+					if (kSignals[i] == signal) {
+						sigaction(signal, &previous_[i], nullptr);
+					}
+				}
+				raise(signal);
+			}
+
+		public:
+			static void install() {
+				AltSignalStack::enabled.store(true, std::memory_order_release);
+				AltSignalStack::ensure();
+				if (installed_.exchange(true)) return;
+
+				struct sigaction action;
+				std::memset(&action, 0, sizeof(action));
+				action.sa_handler = &CrashSignals::handle;
+				sigemptyset(&action.sa_mask);
+				action.sa_flags = SA_ONSTACK;
+				for (size_t i = 0; i < 5; ++i) {
+					sigaction(kSignals[i], &action, &previous_[i]);
+				}
+			}
+		};
+#endif
+
+		// Logger::reopen_on_signal: 처리기는 세대 번호만 올리고 (락 없는 원자 증가), 각 워커가 바뀐 것을 보고 싱크를 다시 연다
+		class ReopenSignal {
+		private:
+			static inline std::atomic<uint64_t> generation_{ 0 };
+
+			static void handle(int) {
+				generation_.fetch_add(1, std::memory_order_relaxed);
+			}
+
+		public:
+			static uint64_t generation() {
+				return generation_.load(std::memory_order_acquire);
+			}
+
+#if !defined(_WIN32)
+			static void install(int signal) {
+				struct sigaction action;
+				std::memset(&action, 0, sizeof(action));
+				action.sa_handler = &ReopenSignal::handle;
+				sigemptyset(&action.sa_mask);
+				action.sa_flags = SA_RESTART;
+				sigaction(signal, &action, nullptr);
+			}
+#endif
+		};
+
+	} // namespace detail
+
+	// 큐가 가득 찼을 때의 처리 방식 (레벨별로 지정 가능)
+	enum class OverflowPolicy {
+		DropOldest,  // 가장 오래된 항목을 버리고 넣는다 (기본값)
+		DropNewest,  // 새 항목을 버린다 (큐는 건드리지 않음)
+		Block,       // 자리가 날 때까지 최대 block_timeout 동안 대기하고, 시간이 지나면 새 항목을 버린다
+		Sample       // 가득 찬 동안 sample_rate개 중 하나만 오래된 항목을 밀어내고 넣고 나머지는 버린다
+	};
+
+	// 로거 자체 계측 스냅샷 (카운터는 Logger 생성 이후 누적)
+	struct LoggerStats {
+		uint64_t enqueued = 0;                         // 기록 요청된 항목 (버려진 항목 포함)
+		uint64_t dropped = 0;                          // 큐가 가득 차서 버린 항목
+		std::array<uint64_t, static_cast<size_t>(LogLevel::FATAL) + 1> dropped_by_level{};
+		size_t queue_depth = 0;                        // 근사값
+		size_t queue_capacity = 0;
+		uint64_t batches = 0;                          // 워커가 싱크에 넘긴 배치 수
+		uint64_t batch_entries = 0;
+		uint64_t max_batch = 0;
+		uint64_t enqueue_samples = 0;                  // 64번에 한 번 잰 큐 삽입 시간
+		uint64_t enqueue_p50_ns = 0;
+		uint64_t enqueue_p99_ns = 0;
+		uint64_t enqueue_max_ns = 0;
+		std::vector<SinkStats> sinks;
+
+		// Prometheus 텍스트 노출 형식
+		std::string to_prometheus(const std::string& prefix = "cpplog") const {
+			std::ostringstream os;
+			os << std::setprecision(9);
+
+			auto header = [&](const char* name, const char* type, const char* help) {
+				os << "# HELP " << prefix << '_' << name << ' ' << help << '\n'
+					<< "# TYPE " << prefix << '_' << name << ' ' << type << '\n';
+			};
+
+			header("enqueued_total", "counter", "Log entries submitted to the queue.");
+			os << prefix << "_enqueued_total " << enqueued << '\n';
+
+			header("dropped_total", "counter", "Log entries dropped because the queue was full.");
+			for (size_t i = 0; i < dropped_by_level.size(); ++i) {
+				std::string name = level_to_string(static_cast<LogLevel>(i));
+				name.erase(name.find_last_not_of(' ') + 1);
+				os << prefix << "_dropped_total{level=\"" << name << "\"} " << dropped_by_level[i] << '\n';
+			}
+
+			header("queue_depth", "gauge", "Approximate number of entries waiting in the queue.");
+			os << prefix << "_queue_depth " << queue_depth << '\n';
+			header("queue_capacity", "gauge", "Queue capacity in entries.");
+			os << prefix << "_queue_capacity " << queue_capacity << '\n';
+
+			header("batches_total", "counter", "Batches handed to the sinks by the worker.");
+			os << prefix << "_batches_total " << batches << '\n';
+			header("batch_entries_total", "counter", "Entries handed to the sinks by the worker.");
+			os << prefix << "_batch_entries_total " << batch_entries << '\n';
+			header("batch_max", "gauge", "Largest batch handed to the sinks.");
+			os << prefix << "_batch_max " << max_batch << '\n';
+
+			header("enqueue_latency_seconds", "gauge", "Sampled time to enqueue one entry.");
+			os << prefix << "_enqueue_latency_seconds{quantile=\"0.5\"} " << enqueue_p50_ns / 1e9 << '\n'
+				<< prefix << "_enqueue_latency_seconds{quantile=\"0.99\"} " << enqueue_p99_ns / 1e9 << '\n'
+				<< prefix << "_enqueue_latency_seconds{quantile=\"1\"} " << enqueue_max_ns / 1e9 << '\n';
+
+			struct SinkMetric {
+				const char* name;
+				const char* type;
+				const char* help;
+				double scale;
+				uint64_t SinkStats::* field;
+			};
+			const SinkMetric metrics[] = {
+				{ "sink_entries_total", "counter", "Entries written to the sink.", 1, &SinkStats::entries },
+				{ "sink_writes_total", "counter", "write_batch calls on the sink.", 1, &SinkStats::writes },
+				{ "sink_write_seconds_total", "counter", "Time spent in write_batch.", 1e9, &SinkStats::write_ns },
+				{ "sink_flushes_total", "counter", "flush calls on the sink.", 1, &SinkStats::flushes },
+				{ "sink_flush_seconds_total", "counter", "Time spent in flush.", 1e9, &SinkStats::flush_ns },
+				{ "sink_errors_total", "counter", "Exceptions thrown by the sink.", 1, &SinkStats::errors },
+				{ "sink_bytes_sent_total", "counter", "Bytes sent by the sink.", 1, &SinkStats::bytes_sent },
+				{ "sink_dropped_total", "counter", "Entries dropped inside the sink.", 1, &SinkStats::dropped },
+			};
+			for (const auto& metric : metrics) {
+				if (sinks.empty()) break;
+				header(metric.name, metric.type, metric.help);
+				for (const auto& sink : sinks) {
+					os << prefix << '_' << metric.name << "{group=\"" << sink.worker_group << "\",sink=\"" << sink.index << "\"} ";
+					if (metric.scale == 1) {
+						os << sink.*metric.field;
+					}
+					else {
+						os << static_cast<double>(sink.*metric.field) / metric.scale;
+					}
+					os << '\n';
+				}
+			}
+			return os.str();
+		}
+	};
+
+	class NamedLogger;
+
+	class Logger {
+	private:
+		friend class NamedLogger;
+
+		static constexpr size_t kLevelCount = static_cast<size_t>(LogLevel::FATAL) + 1;
+
+		// 싱크와 플러시 상태 (워커 스레드만 갱신)
+		struct SinkSlot {
+			std::unique_ptr<LogSink> sink;
+			SinkOptions options;
+			size_t pending_bytes = 0;
+			bool dirty = false;
+			bool urgent = false;
+			std::chrono::steady_clock::time_point last_flush;
+			std::unique_ptr<detail::SinkCounters> counters;
+			std::unique_ptr<std::regex> message_regex;   // SinkOptions::message_regex를 add_sink에서 컴파일
+			bool filtered = false;                       // 레벨 외의 필터가 있거나 min_level이 DEBUG보다 높음
+		};
+
+		// 기본 워커가 그룹 워커들에게 나눠 주는 배치 (마지막으로 놓는 워커가 풀에 돌려준다)
+		struct SharedBatch {
+			std::vector<LogEntry> entries;
+			std::atomic<int> refs{ 0 };
+		};
+
+		struct SinkGroup;
+
+		// 싱크 목록 스냅샷: 만든 뒤에는 바뀌지 않고 publish_sinks가 통째로 교체한다
+		// 슬롯은 여러 스냅샷이 공유하며, 슬롯의 플러시 상태는 그 슬롯을 맡은 워커만 갱신한다.
+		struct SinkList {
+			std::vector<std::shared_ptr<SinkSlot>> slots;
+			std::vector<SinkGroup*> groups;       // 기본 워커 목록에만 채운다
+			int text_level = kSyncOff;            // 텍스트가 필요한 가장 낮은 레벨 (모든 그룹 포함)
+		};
+
+		// 전용 워커 스레드를 가진 싱크 그룹 (SinkOptions::worker_group)
+		struct SinkGroup {
+			int id = 0;
+			std::atomic<const SinkList*> sinks{ nullptr };
+			detail::EpochReader reader;
+			std::mutex mutex;
+			std::condition_variable cv;
+			std::condition_variable space_cv;  // 그룹 워커가 배치를 꺼낼 때 알림 (Block 정책으로 기다리는 기본 워커)
+			std::deque<SharedBatch*> batches;
+			std::atomic<uint64_t> dropped{ 0 };  // 밀린 배치가 넘쳐서 이 그룹에 전달하지 못한 항목
+			uint64_t flush_ticket = 0;     // 기본 워커가 전달한 flush() 요청 번호 (mutex 보호)
+			uint64_t flushed_ticket = 0;   // 처리를 마친 요청 번호 (flush_mutex_ 보호)
+			bool stop = false;
+			std::thread thread;
+		};
+
+		// 기본 워커의 싱크 목록 (워커는 배치마다 원자 로드 한 번으로 읽고, 변경은 sinks_mutex_ 아래에서 교체)
+		// 그룹은 소멸자 전까지 줄지 않는다. 교체된 목록은 워커들이 읽기 구간을 벗어난 뒤 지운다.
+		std::atomic<const SinkList*> sinks_;
+		std::vector<std::unique_ptr<SinkGroup>> groups_;
+		std::mutex sinks_mutex_;
+		detail::EpochDomain sink_epoch_;
+		detail::EpochReader worker_reader_;           // 기본 워커와 동기 기록 (delivery_mutex_ 아래에서만 사용)
+		std::vector<const SinkList*> retired_sinks_;  // 워커 스레드에서 바꿔서 바로 지우지 못한 목록
+		std::atomic<uint64_t> reopen_requested_;
+		uint64_t reopened_ = 0;
+		std::unique_ptr<detail::RingBuffer<SharedBatch*>> batch_pool_;
+		std::atomic<LogLevel> min_level_;
+		detail::LoggerRegistry registry_;
+		std::unique_ptr<detail::RingBuffer<LogEntry>> log_queue_;
+		detail::IdleWaiter queue_waiter_;
+		std::thread worker_thread_;
+		std::atomic<bool> running_;
+		std::atomic<bool> initialized_;
+		std::once_flag init_flag_;
+		size_t max_queue_size_;
+
+		// 스레드별 스테이징 모드
+		std::atomic<bool> staging_enabled_;
+		std::atomic<size_t> staging_chunk_size_;
+		std::atomic<std::chrono::milliseconds::rep> staging_max_delay_ms_;
+		std::atomic<detail::StagedChunk*> staged_chunks_;
+		std::unique_ptr<detail::RingBuffer<detail::StagedChunk*>> chunk_pool_;
+		std::mutex stages_mutex_;
+		std::vector<std::shared_ptr<detail::ThreadStage>> stages_;
+		std::atomic<bool> has_stages_;
+		uint64_t instance_id_;
+		std::atomic<bool> deferred_formatting_;
+
+		// 플러시 요청 (Logger::flush): 요청 번호를 받고 워커가 처리한 번호까지 대기
+		std::atomic<uint64_t> flush_requested_;
+		uint64_t flush_completed_;
+		std::mutex flush_mutex_;
+		std::condition_variable flush_cv_;
+		std::atomic<std::chrono::milliseconds::rep> flush_tick_ms_;
+
+		// 큐 넘침 처리와 레벨별 버린 개수 (워커가 주기적으로 "N messages dropped" 항목을 출력)
+		std::array<std::atomic<OverflowPolicy>, kLevelCount> overflow_policy_;
+		std::atomic<std::chrono::milliseconds::rep> overflow_block_ms_;
+		std::atomic<uint32_t> overflow_sample_rate_;
+		std::atomic<uint32_t> overflow_sample_counter_;
+		std::array<std::atomic<uint64_t>, kLevelCount> dropped_;
+		std::array<uint64_t, kLevelCount> reported_dropped_;
+		std::chrono::steady_clock::time_point last_drop_report_;
+		std::mutex space_mutex_;
+		std::condition_variable space_cv_;
+		std::atomic<int> space_waiters_;
+
+		// 자체 계측 (stats)
+		detail::StripedCounter enqueued_;
+		detail::LatencyHistogram enqueue_latency_;
+		std::atomic<uint64_t> batches_;
+		std::atomic<uint64_t> batch_entries_;
+		std::atomic<uint64_t> max_batch_;
+		std::mutex stats_mutex_;
+		std::function<void(const LoggerStats&)> stats_callback_;
+		std::chrono::milliseconds stats_interval_{ 0 };
+		std::chrono::steady_clock::time_point last_stats_report_;
+
+		// LOG_PROFILE 요약 주기 (0이면 출력하지 않음)
+		std::atomic<std::chrono::milliseconds::rep> profile_interval_ms_;
+		std::chrono::steady_clock::time_point last_profile_report_;
+
+		// 연속 중복 메시지 묶기 (set_deduplication, 상태는 워커 스레드만 사용)
+		std::atomic<bool> dedup_enabled_;
+		LogEntry last_message_;
+		bool has_last_message_ = false;
+		uint64_t repeat_count_ = 0;
+		std::chrono::system_clock::time_point repeat_timestamp_;
+		std::thread::id repeat_thread_;
+		std::chrono::steady_clock::time_point repeat_since_;
+		std::vector<LogEntry> dedup_output_;
+
+		// 동기 기록 (set_synchronous, FATAL): 워커와 호출 스레드가 이 락 아래에서만 싱크/중복 묶기 상태를 건드린다
+		static constexpr int kSyncOff = static_cast<int>(LogLevel::FATAL) + 1;
+		std::mutex delivery_mutex_;
+		std::atomic<int> sync_level_;
+		std::vector<LogEntry> sync_batch_;
+
+		// set_worker_options: 버전이 바뀌면 각 워커가 자기 스레드에 다시 적용한다
+		std::mutex worker_options_mutex_;
+		WorkerOptions worker_options_;
+		std::atomic<uint64_t> worker_options_version_;
+
+		// 이 스레드가 이미 싱크 출력 중인지 (워커, 동기 기록 중 싱크 안에서 다시 로그를 남기면 큐로 보낸다)
+		static bool& delivering() {
+			static thread_local bool value = false;
+			return value;
+		}
+
+		static uint64_t next_instance_id() {
+			static std::atomic<uint64_t> counter{ 0 };
+			return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+		}
+
+		// 스레드 종료 시 남은 스테이징 청크를 워커로 넘긴다
+		struct ThreadStageCache {
+			struct Item {
+				uint64_t logger_id;
+				std::shared_ptr<detail::ThreadStage> stage;
+			};
+			std::vector<Item> items;
+
+			~ThreadStageCache() {
+				for (auto& item : items) {
+					std::lock_guard<std::mutex> lock(item.stage->mutex);
+					item.stage->retired.store(true, std::memory_order_relaxed);
+					if (item.stage->owner && item.stage->chunk) {
+						static_cast<Logger*>(item.stage->owner)->publish_chunk(item.stage->chunk);
+						item.stage->chunk = nullptr;
+					}
+				}
+			}
+		};
+
+		template<typename T>
+		void safe_append(std::ostream& os, T&& value) {
+			using Value = std::decay_t<T>;
+			if constexpr (detail::has_fast_text_v<Value>) {
+				if (detail::plain_stream(os)) {
+					detail::write_fast_text(os, static_cast<const Value&>(value));
+					return;
+				}
+			}
+			try {
+				os << std::forward<T>(value);
+			}
+			catch (...) {
+				os << "[FORMAT_ERROR]";
+			}
+		}
+
+		void format_recursive(std::ostream& os, std::string_view format) {
+			os.write(format.data(), static_cast<std::streamsize>(format.size()));
+		}
+
+		template<typename T, typename... Args>
+		void format_recursive(std::ostream& os, std::string_view format,
+			T&& value, Args&&... args) {
+			size_t pos = format.find("{}");
+			if (pos != std::string_view::npos) {
+				os.write(format.data(), static_cast<std::streamsize>(pos));
+				safe_append(os, std::forward<T>(value));
+				format_recursive(os, format.substr(pos + 2), std::forward<Args>(args)...);
+			}
+			else {
+				format_recursive(os, format);
+				// 남은 인자들은 무시 (포맷 문자열에 {} 부족)
+			}
+		}
+
+		void ensure_initialized() {
+			if (!initialized_.load(std::memory_order_acquire)) {
+				std::call_once(init_flag_, [this] {
+					log_queue_ = std::make_unique<detail::RingBuffer<LogEntry>>(max_queue_size_);
+					chunk_pool_ = std::make_unique<detail::RingBuffer<detail::StagedChunk*>>(64);
+					batch_pool_ = std::make_unique<detail::RingBuffer<SharedBatch*>>(64);
+					running_ = true;
+					worker_thread_ = std::thread(&Logger::worker_loop, this);
+					initialized_.store(true, std::memory_order_release);
+					});
+			}
+		}
+
+		void log_entry(LogEntry&& entry) {
+			ensure_initialized();
+			enqueued_.add(1);
+
+			if ((entry.level == LogLevel::FATAL
+				|| static_cast<int>(entry.level) >= sync_level_.load(std::memory_order_relaxed)) && !delivering()) {
+				deliver_now(std::move(entry));
+				return;
+			}
+
+			// 64번에 한 번만 큐에 넣는 시간을 잰다
+			thread_local uint32_t sample_tick = 0;
+			if ((++sample_tick & 63) != 0) {
+				push_entry(std::move(entry));
+				return;
+			}
+			auto start = std::chrono::steady_clock::now();
+			push_entry(std::move(entry));
+			enqueue_latency_.record(detail::elapsed_ns(start));
+		}
+
+		// 호출한 스레드에서 바로 기록: 먼저 큐와 스테이징에 남은 항목을 내보내서 순서를 지킨다
+		// FATAL은 모든 싱크를 플러시하고, 그룹 싱크가 있으면 그 출력까지 기다린 뒤 반환한다.
+		void deliver_now(LogEntry&& entry) {
+			bool fatal = entry.level == LogLevel::FATAL;
+			bool has_groups = false;
+			{
+				std::lock_guard<std::mutex> lock(delivery_mutex_);
+				detail::EpochDomain::Guard pin(sink_epoch_, worker_reader_);
+				delivering() = true;
+				has_groups = !current_sinks().groups.empty();
+
+				size_t drained = 0;
+				size_t count = 0;
+				do {
+					sync_batch_.clear();
+					count = drain_queue(sync_batch_, 100);
+					dispatch_batch(sync_batch_);
+					drained += count;
+				} while (count > 0 && drained < log_queue_->capacity());
+				sweep_stages(true);
+				drain_staged();
+
+				sync_batch_.clear();
+				sync_batch_.push_back(std::move(entry));
+				dispatch_batch(sync_batch_);
+				if (fatal) {
+					report_repeats(true);
+				}
+
+				try {
+					flush_sinks(fatal);
+				}
+				catch (...) {
+				}
+				delivering() = false;
+			}
+
+			if (fatal && has_groups) {
+				flush();
+			}
+		}
+
+		void push_entry(LogEntry&& entry) {
+			if (staging_enabled_.load(std::memory_order_relaxed)) {
+				stage_entry(std::move(entry));
+				return;
+			}
+
+			if (!log_queue_->try_push(std::move(entry))) {
+				push_overflowed(std::move(entry));
+			}
+
+			queue_waiter_.notify();
+		}
+
+		void count_dropped(LogLevel level) {
+			dropped_[static_cast<size_t>(level)].fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// 큐가 가득 찬 경우: 항목 레벨의 넘침 정책에 따라 넣거나 버린다
+		void push_overflowed(LogEntry&& entry) {
+			OverflowPolicy policy = overflow_policy_[static_cast<size_t>(entry.level)].load(std::memory_order_relaxed);
+
+			// 워커 스레드(싱크 내부 로깅)가 대기하면 스스로를 막으므로 새 항목을 버린다
+			if (policy == OverflowPolicy::Block && delivering()) {
+				policy = OverflowPolicy::DropNewest;
+			}
+
+			switch (policy) {
+			case OverflowPolicy::DropNewest:
+				count_dropped(entry.level);
+				return;
+
+			case OverflowPolicy::Sample: {
+				uint32_t rate = overflow_sample_rate_.load(std::memory_order_relaxed);
+				if (overflow_sample_counter_.fetch_add(1, std::memory_order_relaxed) % rate != 0) {
+					count_dropped(entry.level);
+					return;
+				}
+				break;  // 표본은 오래된 항목을 밀어내고 넣는다
+			}
+
+			case OverflowPolicy::Block:
+				if (!wait_for_space(entry)) {
+					count_dropped(entry.level);
+				}
+				return;
+
+			case OverflowPolicy::DropOldest:
+				break;
+			}
+
+			while (!log_queue_->try_push(std::move(entry))) {
+				LogEntry dropped;
+				if (log_queue_->try_pop(dropped)) {
+					count_dropped(dropped.level);
+				}
+			}
+		}
+
+		// 워커가 자리를 비울 때까지 최대 overflow_block_ms_ 동안 대기 (넣었으면 true)
+		bool wait_for_space(LogEntry& entry) {
+			auto deadline = std::chrono::steady_clock::now()
+				+ std::chrono::milliseconds(overflow_block_ms_.load(std::memory_order_relaxed));
+
+			std::unique_lock<std::mutex> lock(space_mutex_);
+			space_waiters_.fetch_add(1, std::memory_order_seq_cst);
+			bool pushed = false;
+			while (!(pushed = log_queue_->try_push(std::move(entry)))) {
+				if (!running_.load(std::memory_order_acquire)
+					|| space_cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+					pushed = log_queue_->try_push(std::move(entry));
+					break;
+				}
+			}
+			space_waiters_.fetch_sub(1, std::memory_order_relaxed);
+			return pushed;
+		}
+
+		// 워커 측: 큐에서 꺼낸 뒤 대기 중인 생산자를 깨움
+		void notify_space() {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (space_waiters_.load(std::memory_order_relaxed) > 0) {
+				std::lock_guard<std::mutex> lock(space_mutex_);
+				space_cv_.notify_all();
+			}
+		}
+
+		// 마지막 보고 이후 버린 항목이 있으면 1초에 한 번 WARN 항목으로 직접 싱크에 출력 (큐를 거치지 않음)
+		void report_dropped(bool force) {
+			auto now = std::chrono::steady_clock::now();
+			if (!force && now - last_drop_report_ < std::chrono::seconds(1)) return;
+
+			uint64_t total = 0;
+			std::array<uint64_t, kLevelCount> delta{};
+			for (size_t i = 0; i < kLevelCount; ++i) {
+				uint64_t current = dropped_[i].load(std::memory_order_relaxed);
+				delta[i] = current - reported_dropped_[i];
+				reported_dropped_[i] = current;
+				total += delta[i];
+			}
+			if (total == 0) return;
+			last_drop_report_ = now;
+
+			std::vector<LogEntry> report(1);
+			LogEntry& entry = report.front();
+			entry.timestamp = std::chrono::system_clock::now();
+			entry.level = LogLevel::WARN;
+			entry.thread_id = std::this_thread::get_id();
+			{
+				detail::MessageStream stream(entry.message);
+				std::ostream& os = stream.get();
+				os << total << " messages dropped (queue full:";
+				for (size_t i = 0; i < kLevelCount; ++i) {
+					if (delta[i] > 0) {
+						std::string name = level_to_string(static_cast<LogLevel>(i));
+						name.erase(name.find_last_not_of(' ') + 1);
+						os << ' ' << name << '=' << delta[i];
+					}
+				}
+				os << ')';
+			}
+			dispatch_batch(report);
+		}
+
+		// set_stats_callback 주기마다 워커 스레드에서 콜백 호출
+		void report_stats() {
+			std::lock_guard<std::mutex> lock(stats_mutex_);
+			if (!stats_callback_ || stats_interval_.count() <= 0) return;
+
+			auto now = std::chrono::steady_clock::now();
+			if (now - last_stats_report_ < stats_interval_) return;
+			last_stats_report_ = now;
+
+			try {
+				stats_callback_(stats());
+			}
+			catch (const std::exception& e) {
+				std::cerr << "Logger stats callback error: " << e.what() << std::endl;
+			}
+		}
+
+		// group_dropped: 그룹 워커에 전달하지 못하고 버린 항목 (그 그룹의 싱크마다 dropped에 더한다)
+		static void collect_sink_stats(const std::vector<std::shared_ptr<SinkSlot>>& slots, int worker_group,
+			std::vector<SinkStats>& out, uint64_t group_dropped = 0) {
+			for (size_t i = 0; i < slots.size(); ++i) {
+				const detail::SinkCounters& counters = *slots[i]->counters;
+				SinkStats sink;
+				sink.index = i;
+				sink.worker_group = worker_group;
+				sink.entries = counters.entries.load(std::memory_order_relaxed);
+				sink.writes = counters.writes.load(std::memory_order_relaxed);
+				sink.write_ns = counters.write_ns.load(std::memory_order_relaxed);
+				sink.flushes = counters.flushes.load(std::memory_order_relaxed);
+				sink.flush_ns = counters.flush_ns.load(std::memory_order_relaxed);
+				sink.errors = counters.errors.load(std::memory_order_relaxed);
+				slots[i]->sink->collect_stats(sink);
+				sink.dropped += group_dropped;
+				out.push_back(sink);
+			}
+		}
+
+		// 이름마다 한 줄: "profile db.query: count=1200 p50=12.3us p99=85.0us max=1.20ms"
+		void report_profiles(bool force) {
+			auto interval = profile_interval_ms_.load(std::memory_order_relaxed);
+			if (interval <= 0) return;
+
+			auto now = std::chrono::steady_clock::now();
+			if (!force && now - last_profile_report_ < std::chrono::milliseconds(interval)) return;
+			last_profile_report_ = now;
+
+			std::vector<detail::ProfileSummary> summaries = detail::ProfileRegistry::instance().collect();
+			if (summaries.empty() || !persists(LogLevel::INFO)) return;
+
+			std::vector<LogEntry> report(summaries.size());
+			for (size_t i = 0; i < summaries.size(); ++i) {
+				const auto& summary = summaries[i];
+				LogEntry& entry = report[i];
+				entry.timestamp = std::chrono::system_clock::now();
+				entry.level = LogLevel::INFO;
+				entry.thread_id = std::this_thread::get_id();
+
+				detail::MessageStream stream(entry.message);
+				std::ostream& os = stream.get();
+				os << "profile " << summary.name << ": count=" << summary.count << " p50=";
+				detail::append_duration(os, summary.p50);
+				os << " p99=";
+				detail::append_duration(os, summary.p99);
+				os << " max=";
+				detail::append_duration(os, summary.max);
+			}
+			dispatch_batch(report);
+		}
+
+		detail::ThreadStage& local_stage() {
+			static thread_local ThreadStageCache cache;
+			for (auto& item : cache.items) {
+				if (item.logger_id == instance_id_) {
+					return *item.stage;
+				}
+			}
+
+			auto stage = std::make_shared<detail::ThreadStage>();
+			stage->owner = this;
+			{
+				std::lock_guard<std::mutex> lock(stages_mutex_);
+				stages_.push_back(stage);
+			}
+			has_stages_.store(true, std::memory_order_release);
+			cache.items.push_back({ instance_id_, stage });
+			return *stage;
+		}
+
+		void stage_entry(LogEntry&& entry) {
+			detail::ThreadStage& stage = local_stage();
+			std::lock_guard<std::mutex> lock(stage.mutex);
+
+			if (!stage.chunk) {
+				if (!chunk_pool_->try_pop(stage.chunk)) {
+					stage.chunk = new detail::StagedChunk;
+					stage.chunk->entries.reserve(staging_chunk_size_.load(std::memory_order_relaxed));
+				}
+				stage.first_timestamp = entry.timestamp;
+			}
+
+			auto age = entry.timestamp - stage.first_timestamp;
+			stage.chunk->entries.emplace_back(std::move(entry));
+
+			// 청크가 가득 찼거나 시간 제한을 넘으면 워커로 넘김
+			if (stage.chunk->entries.size() >= staging_chunk_size_.load(std::memory_order_relaxed)
+				|| age >= std::chrono::milliseconds(staging_max_delay_ms_.load(std::memory_order_relaxed))) {
+				publish_chunk(stage.chunk);
+				stage.chunk = nullptr;
+			}
+		}
+
+		// 청크당 CAS 한 번으로 워커에 전달 (Treiber 스택)
+		void publish_chunk(detail::StagedChunk* chunk) {
+			chunk->next = staged_chunks_.load(std::memory_order_relaxed);
+			while (!staged_chunks_.compare_exchange_weak(chunk->next, chunk,
+				std::memory_order_release, std::memory_order_relaxed)) {
+			}
+			queue_waiter_.notify();
+		}
+
+		// 오래 머문 스테이징 청크를 회수 (publish_all이면 모두 회수, detach면 스레드와 분리)
+		void sweep_stages(bool publish_all, bool detach = false) {
+			if (!has_stages_.load(std::memory_order_acquire)) return;
+
+			std::vector<std::shared_ptr<detail::ThreadStage>> stages;
+			{
+				std::lock_guard<std::mutex> lock(stages_mutex_);
+				stages = stages_;
+			}
+
+			auto max_delay = std::chrono::milliseconds(staging_max_delay_ms_.load(std::memory_order_relaxed));
+			auto now = std::chrono::system_clock::now();
+			bool any_retired = false;
+
+			for (auto& stage : stages) {
+				std::unique_lock<std::mutex> lock(stage->mutex, std::defer_lock);
+				if (publish_all) {
+					lock.lock();
+				}
+				else if (!lock.try_lock()) {
+					continue;  // 소유 스레드가 기록 중이면 스스로 넘긴다
+				}
+
+				if (stage->chunk && (publish_all || now - stage->first_timestamp >= max_delay)) {
+					publish_chunk(stage->chunk);
+					stage->chunk = nullptr;
+				}
+				if (detach) {
+					stage->owner = nullptr;
+				}
+				any_retired = any_retired || stage->retired.load(std::memory_order_relaxed);
+			}
+
+			if (any_retired || detach) {
+				std::lock_guard<std::mutex> lock(stages_mutex_);
+				stages_.erase(std::remove_if(stages_.begin(), stages_.end(),
+					[detach](const std::shared_ptr<detail::ThreadStage>& stage) {
+						return detach || stage->retired.load(std::memory_order_relaxed);
+					}), stages_.end());
+				has_stages_.store(!stages_.empty(), std::memory_order_release);
+			}
+		}
+
+		// 넘겨받은 청크들을 도착 순서대로 싱크에 출력
+		bool drain_staged() {
+			detail::StagedChunk* list = staged_chunks_.exchange(nullptr, std::memory_order_acquire);
+			if (!list) return false;
+
+			detail::StagedChunk* ordered = nullptr;
+			while (list) {
+				detail::StagedChunk* next = list->next;
+				list->next = ordered;
+				ordered = list;
+				list = next;
+			}
+
+			while (ordered) {
+				detail::StagedChunk* chunk = ordered;
+				ordered = chunk->next;
+
+				dispatch_batch(chunk->entries);
+
+				chunk->entries.clear();
+				chunk->next = nullptr;
+				if (!chunk_pool_->try_push(chunk)) {
+					delete chunk;
+				}
+			}
+			return true;
+		}
+
+		size_t drain_queue(std::vector<LogEntry>& batch, size_t limit) {
+			LogEntry entry;
+			while (batch.size() < limit && log_queue_->try_pop(entry)) {
+				batch.emplace_back(std::move(entry));
+			}
+			if (!batch.empty()) {
+				notify_space();
+			}
+			return batch.size();
+		}
+
+		// 지연 포맷된 항목의 message를 워커 스레드에서 채움 (인자 바이트 뒤에 텍스트를 이어서 기록)
+		// format/arg_types는 바이너리 싱크를 위해 남겨 두고, 이미 텍스트가 있으면 건너뛴다.
+		static void format_deferred(LogEntry& entry) {
+			if (!entry.format || entry.message.size() > 0) return;
+
+			try {
+				detail::MessageStream stream(entry.message);
+				detail::format_packed(stream.get(), entry.format, entry.arg_types,
+					entry.message.args(), entry.format_args_size());
+			}
+			catch (...) {
+				entry.message.clear();
+				entry.message.append("[LOG_ERROR] ");
+				entry.message.append(entry.format);
+			}
+		}
+
+		// 워커 읽기 구간(worker_reader_ 고정) 안에서만 호출
+		const SinkList& current_sinks() const {
+			return *sinks_.load(std::memory_order_seq_cst);
+		}
+
+		// 배치 처리된 로그들을 모든 싱크에 출력
+		// 싱크 그룹이 있으면 배치 내용을 공유 배치로 옮겨서 각 그룹 워커에 넘긴다 (batch는 비워진 벡터로 바뀐다).
+		void dispatch_batch(std::vector<LogEntry>& batch) {
+			if (batch.empty()) return;
+
+			if (dedup_enabled_.load(std::memory_order_relaxed)) {
+				collapse_repeats(batch);
+			}
+			deliver_batch(batch);
+		}
+
+		// 지연 포맷 항목은 포맷 포인터와 인자 바이트로, 나머지는 텍스트로 비교한다
+		static bool same_message(const LogEntry& lhs, const LogEntry& rhs) {
+			if (lhs.level != rhs.level || lhs.logger_name != rhs.logger_name) return false;
+			if (lhs.field_bytes != rhs.field_bytes
+				|| std::memcmp(lhs.fields_data(), rhs.fields_data(), lhs.field_bytes) != 0) return false;
+
+			bool lhs_raw = lhs.format && lhs.message.empty();
+			bool rhs_raw = rhs.format && rhs.message.empty();
+			if (lhs_raw != rhs_raw) return false;
+			if (lhs_raw) {
+				return lhs.format == rhs.format && lhs.arg_types == rhs.arg_types
+					&& lhs.format_args_size() == rhs.format_args_size()
+					&& std::memcmp(lhs.message.args(), rhs.message.args(), lhs.format_args_size()) == 0;
+			}
+			return lhs.message.view() == rhs.message.view();
+		}
+
+		// 직전 메시지와 같은 항목은 빼고 개수만 센다 (다른 메시지가 오면 요약 항목을 그 앞에 넣는다)
+		void collapse_repeats(std::vector<LogEntry>& batch) {
+			dedup_output_.clear();
+			for (auto& entry : batch) {
+				if (has_last_message_ && same_message(entry, last_message_)) {
+					if (repeat_count_++ == 0) {
+						repeat_since_ = std::chrono::steady_clock::now();
+					}
+					repeat_timestamp_ = entry.timestamp;
+					repeat_thread_ = entry.thread_id;
+					continue;
+				}
+
+				if (repeat_count_ > 0) {
+					dedup_output_.push_back(make_repeat_entry());
+				}
+				last_message_ = entry;
+				has_last_message_ = true;
+				dedup_output_.push_back(std::move(entry));
+			}
+			batch.swap(dedup_output_);
+			dedup_output_.clear();
+		}
+
+		LogEntry make_repeat_entry() {
+			LogEntry entry;
+			entry.timestamp = repeat_timestamp_;
+			entry.level = last_message_.level;
+			entry.thread_id = repeat_thread_;
+			entry.logger_name = last_message_.logger_name;
+			{
+				detail::MessageStream stream(entry.message);
+				stream.get() << "last message repeated " << repeat_count_ << " times";
+			}
+			repeat_count_ = 0;
+			return entry;
+		}
+
+		// 같은 메시지가 계속 이어지는 동안에도 1초마다, 그리고 플러시/종료 시 요약을 출력
+		void report_repeats(bool force) {
+			if (repeat_count_ == 0) return;
+			if (!force && std::chrono::steady_clock::now() - repeat_since_ < std::chrono::seconds(1)) return;
+
+			std::vector<LogEntry> report;
+			report.push_back(make_repeat_entry());
+			deliver_batch(report);
+		}
+
+		void deliver_batch(std::vector<LogEntry>& batch) {
+			if (batch.empty()) return;
+
+			batches_.store(batches_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			batch_entries_.store(batch_entries_.load(std::memory_order_relaxed) + batch.size(), std::memory_order_relaxed);
+			if (batch.size() > max_batch_.load(std::memory_order_relaxed)) {
+				max_batch_.store(batch.size(), std::memory_order_relaxed);
+			}
+
+			const SinkList& sinks = current_sinks();
+			int level = sinks.text_level;
+			if (level < kSyncOff) {
+				for (auto& entry : batch) {
+					if (static_cast<int>(entry.level) >= level) {
+						format_deferred(entry);
+					}
+				}
+			}
+
+			write_slots(sinks.slots, batch.data(), batch.size());
+
+			if (!sinks.groups.empty()) {
+				fan_out(sinks.groups, batch);
+			}
+		}
+
+		static void write_slots(const std::vector<std::shared_ptr<SinkSlot>>& slots, const LogEntry* entries, size_t count) {
+			size_t bytes = 0;
+			LogLevel max_level = LogLevel::DEBUG;
+			for (size_t i = 0; i < count; ++i) {
+				bytes += entries[i].message.size() + 1;
+				max_level = (std::max)(max_level, entries[i].level);
+			}
+
+			for (const auto& shared_slot : slots) {
+				SinkSlot& slot = *shared_slot;
+				if (!slot.filtered) {
+					write_slot(slot, entries, count, bytes, max_level);
+					continue;
+				}
+
+				// 필터를 통과한 연속 구간마다 한 번씩 전달 (배치를 복사하지 않고, 항목마다 필터는 한 번만 검사)
+				size_t i = 0;
+				while (i < count) {
+					while (i < count && !accepts(slot, entries[i])) {
+						++i;
+					}
+					if (i == count) break;
+
+					size_t begin = i;
+					size_t run_bytes = entries[i].message.size() + 1;
+					LogLevel run_level = entries[i].level;
+					for (++i; i < count && accepts(slot, entries[i]); ++i) {
+						run_bytes += entries[i].message.size() + 1;
+						run_level = (std::max)(run_level, entries[i].level);
+					}
+					write_slot(slot, entries + begin, i - begin, run_bytes, run_level);
+					++i;  // 구간을 끝낸 항목은 이미 걸러졌다
+				}
+			}
+		}
+
+		static void write_slot(SinkSlot& slot, const LogEntry* entries, size_t count, size_t bytes, LogLevel max_level) {
+			auto start = std::chrono::steady_clock::now();
+			try {
+				slot.sink->write_batch(entries, count);
+			}
+			catch (const std::exception& e) {
+				// 싱크 오류는 무시하고 계속 진행
+				std::cerr << "Logger sink error: " << e.what() << std::endl;
+				detail::SinkCounters::bump(slot.counters->errors, 1);
+			}
+			detail::SinkCounters::bump(slot.counters->write_ns, detail::elapsed_ns(start));
+			detail::SinkCounters::bump(slot.counters->writes, 1);
+			detail::SinkCounters::bump(slot.counters->entries, count);
+
+			const FlushPolicy& policy = slot.options.flush;
+			slot.dirty = true;
+			slot.pending_bytes += bytes;
+			slot.urgent = slot.urgent || (policy.level_trigger && max_level >= policy.min_level);
+		}
+
+		// SinkOptions 필터 검사 (싼 것부터: 레벨, 로거 이름, 정규식, 사용자 함수)
+		static bool accepts(const SinkSlot& slot, const LogEntry& entry) {
+			const SinkOptions& options = slot.options;
+			if (entry.level < options.min_level) return false;
+
+			if (!options.loggers.empty()) {
+				std::string_view name = entry.logger_name ? std::string_view(entry.logger_name) : std::string_view();
+				bool matched = std::any_of(options.loggers.begin(), options.loggers.end(), [name](const std::string& prefix) {
+					return name == prefix
+						|| (!prefix.empty() && name.size() > prefix.size() && name[prefix.size()] == '.'
+							&& name.compare(0, prefix.size(), prefix) == 0);
+					});
+				if (!matched) return false;
+			}
+
+			if (slot.message_regex) {
+				std::string_view text = entry.message.view();
+				if (!std::regex_search(text.begin(), text.end(), *slot.message_regex)) return false;
+			}
+
+			if (options.filter) {
+				try {
+					return options.filter(entry);
+				}
+				catch (...) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// 배치 하나를 참조 카운트로 공유해서 모든 그룹 큐에 넣는다
+		// 밀린 배치가 한도를 넘은 그룹은 가장 오래된 배치를 버린다 (큐가 가득 찼을 때와 같은 규칙).
+		void fan_out(const std::vector<SinkGroup*>& groups, std::vector<LogEntry>& batch) {
+			SharedBatch* shared = nullptr;
+			if (!batch_pool_->try_pop(shared)) {
+				shared = new SharedBatch;
+				shared->entries.reserve(batch.capacity());
+			}
+			shared->entries.swap(batch);
+			shared->refs.store(static_cast<int>(groups.size()), std::memory_order_relaxed);
+
+			// 느린 그룹의 밀린 배치가 한도에 닿으면 가장 오래된 배치를 버린다. 그 배치에 Block 정책 레벨의
+			// 항목이 있으면 먼저 block_timeout까지 그룹 워커가 배치를 꺼내기를 기다린다.
+			size_t backlog_limit = (std::max)(max_queue_size_ / 100, static_cast<size_t>(8));
+			for (SinkGroup* group : groups) {
+				SharedBatch* dropped = nullptr;
+				{
+					std::unique_lock<std::mutex> lock(group->mutex);
+					if (group->batches.size() >= backlog_limit && blocks_on(*group->batches.front())) {
+						auto deadline = std::chrono::steady_clock::now()
+							+ std::chrono::milliseconds(overflow_block_ms_.load(std::memory_order_relaxed));
+						group->space_cv.wait_until(lock, deadline,
+							[&] { return group->batches.size() < backlog_limit || group->stop; });
+					}
+					if (group->batches.size() >= backlog_limit) {
+						dropped = group->batches.front();
+						group->batches.pop_front();
+					}
+					group->batches.push_back(shared);
+				}
+				group->cv.notify_one();
+				if (dropped) {
+					for (const auto& entry : dropped->entries) {
+						count_dropped(entry.level);
+					}
+					group->dropped.fetch_add(dropped->entries.size(), std::memory_order_relaxed);
+					release_batch(dropped);
+				}
+			}
+		}
+
+		bool blocks_on(const SharedBatch& shared) const {
+			for (const auto& entry : shared.entries) {
+				if (overflow_policy_[static_cast<size_t>(entry.level)].load(std::memory_order_relaxed) == OverflowPolicy::Block) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void release_batch(SharedBatch* shared) {
+			if (shared->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+			shared->entries.clear();
+			if (!batch_pool_->try_push(shared)) {
+				delete shared;
+			}
+		}
+
+		// 워커 스레드가 자기 자신에게 적용 (nice 값과 SCHED_IDLE은 호출한 스레드에만 걸 수 있다)
+		void apply_worker_options(uint64_t& applied) {
+			uint64_t version = worker_options_version_.load(std::memory_order_acquire);
+			if (version == applied) return;
+			applied = version;
+
+			WorkerOptions options;
+			{
+				std::lock_guard<std::mutex> lock(worker_options_mutex_);
+				options = worker_options_;
+			}
+			std::string error = detail::configure_current_thread(options);
+			if (!error.empty()) {
+				std::cerr << "Logger worker options error: " << error << std::endl;
+			}
+		}
+
+		// 그룹 워커: 넘겨받은 배치를 그룹의 싱크에 출력하고 그룹 단위로 플러시 정책을 적용
+		void group_loop(SinkGroup& group) {
+			uint64_t handled_ticket = 0;
+			uint64_t options_version = 0;
+			uint64_t reopened = reopen_ticket();
+			delivering() = true;
+
+			for (;;) {
+				apply_worker_options(options_version);
+				SharedBatch* shared = nullptr;
+				uint64_t ticket = 0;
+				bool stop = false;
+				{
+					std::unique_lock<std::mutex> lock(group.mutex);
+					group.cv.wait_for(lock, std::chrono::milliseconds(flush_tick_ms_.load(std::memory_order_relaxed)),
+						[&] {
+							return group.stop || !group.batches.empty() || group.flush_ticket != handled_ticket
+								|| reopen_ticket() != reopened;
+						});
+					if (!group.batches.empty()) {
+						shared = group.batches.front();
+						group.batches.pop_front();
+					}
+					ticket = group.flush_ticket;
+					stop = group.stop;
+				}
+				if (shared) {
+					group.space_cv.notify_one();
+				}
+
+				detail::EpochDomain::Guard pin(sink_epoch_, group.reader);
+				const auto& slots = group.sinks.load(std::memory_order_seq_cst)->slots;
+				reopen_if_requested(slots, reopened);
+
+				if (shared) {
+					write_slots(slots, shared->entries.data(), shared->entries.size());
+					release_batch(shared);
+					flush_slots(slots, false);
+					continue;
+				}
+
+				// 큐가 빈 뒤에만 flush() 요청을 완료 처리 (요청 전 배치는 모두 출력된 상태)
+				if (ticket != handled_ticket || stop) {
+					flush_slots(slots, true);
+					handled_ticket = ticket;
+					{
+						std::lock_guard<std::mutex> lock(flush_mutex_);
+						group.flushed_ticket = stop ? flush_requested_.load(std::memory_order_acquire) : ticket;
+					}
+					flush_cv_.notify_all();
+					if (stop) return;
+					continue;
+				}
+
+				flush_slots(slots, false);
+			}
+		}
+
+		void flush_sinks(bool force) {
+			flush_slots(current_sinks().slots, force);
+		}
+
+		// reopen_sinks()나 재열기 신호 이후 처음 도는 워커가 자기 싱크를 다시 연다 (쓰지 않은 내용은 먼저 플러시)
+		uint64_t reopen_ticket() const {
+			return reopen_requested_.load(std::memory_order_acquire) + detail::ReopenSignal::generation();
+		}
+
+		void reopen_if_requested(const std::vector<std::shared_ptr<SinkSlot>>& slots, uint64_t& reopened) {
+			uint64_t ticket = reopen_ticket();
+			if (ticket == reopened) return;
+			reopened = ticket;
+
+			flush_slots(slots, true);
+			for (const auto& slot : slots) {
+				try {
+					slot->sink->reopen();
+				}
+				catch (const std::exception& e) {
+					std::cerr << "Logger sink reopen error: " << e.what() << std::endl;
+					detail::SinkCounters::bump(slot->counters->errors, 1);
+				}
+			}
+		}
+
+		// 정책상 플러시할 때가 된 싱크만 플러시 (force면 기록이 있었던 싱크 모두)
+		static void flush_slots(const std::vector<std::shared_ptr<SinkSlot>>& slots, bool force) {
+			auto now = std::chrono::steady_clock::now();
+			for (const auto& shared_slot : slots) {
+				SinkSlot& slot = *shared_slot;
+				if (!slot.dirty) continue;
+
+				const FlushPolicy& policy = slot.options.flush;
+				bool due = force || slot.urgent
+					|| (policy.max_bytes > 0 && slot.pending_bytes >= policy.max_bytes)
+					|| (policy.interval.count() > 0 && now - slot.last_flush >= policy.interval);
+				if (!due) continue;
+
+				auto start = std::chrono::steady_clock::now();
+				try {
+					slot.sink->flush();
+				}
+				catch (const std::exception& e) {
+					std::cerr << "Logger sink flush error: " << e.what() << std::endl;
+					detail::SinkCounters::bump(slot.counters->errors, 1);
+				}
+				detail::SinkCounters::bump(slot.counters->flush_ns, detail::elapsed_ns(start));
+				detail::SinkCounters::bump(slot.counters->flushes, 1);
+				slot.dirty = false;
+				slot.urgent = false;
+				slot.pending_bytes = 0;
+				slot.last_flush = now;
+			}
+		}
+
+		// flush() 요청 처리: 요청 전에 들어온 로그를 모두 출력하고 싱크를 플러시한 뒤 대기자를 깨운다
+		void complete_flush(std::vector<LogEntry>& batch, uint64_t ticket) {
+			// 요청 이전 항목은 큐 용량을 넘지 않으므로 그만큼만 비운다 (계속 들어오는 로그로 무한히 돌지 않도록)
+			size_t drained = 0;
+			size_t count = 0;
+			do {
+				batch.clear();
+				count = drain_queue(batch, 100);
+				dispatch_batch(batch);
+				drained += count;
+			} while (count > 0 && drained < log_queue_->capacity());
+
+			sweep_stages(true);
+			drain_staged();
+			report_repeats(true);
+			flush_sinks(true);
+
+			// 그룹 워커는 앞서 넘긴 배치를 모두 출력한 뒤 각자 완료를 알린다
+			for (SinkGroup* group : current_sinks().groups) {
+				{
+					std::lock_guard<std::mutex> lock(group->mutex);
+					group->flush_ticket = ticket;
+				}
+				group->cv.notify_one();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(flush_mutex_);
+				flush_completed_ = ticket;
+			}
+			flush_cv_.notify_all();
+		}
+
+		// 슬롯 목록 [0]은 기본 워커, [i]는 groups_[i - 1] (sinks_mutex_ 아래에서 사용)
+		using SlotLists = std::vector<std::vector<std::shared_ptr<SinkSlot>>>;
+
+		SlotLists current_slot_lists() const {
+			SlotLists lists;
+			lists.push_back(sinks_.load(std::memory_order_relaxed)->slots);
+			for (const auto& group : groups_) {
+				lists.push_back(group->sinks.load(std::memory_order_relaxed)->slots);
+			}
+			return lists;
+		}
+
+		// 새 스냅샷들을 게시하고 이전 스냅샷을 retired에 모은다 (sinks_mutex_ 아래에서 호출)
+		void publish_sinks(const SlotLists& lists, std::vector<const SinkList*>& retired) {
+			int text_level = kSyncOff;
+			for (const auto& slots : lists) {
+				for (const auto& slot : slots) {
+					if (slot->sink->uses_message_text() || slot->message_regex) {
+						text_level = (std::min)(text_level, static_cast<int>(slot->options.min_level));
+					}
+				}
+			}
+
+			for (size_t i = 0; i < groups_.size(); ++i) {
+				auto* list = new SinkList;
+				list->slots = lists[i + 1];
+				const SinkList* old = groups_[i]->sinks.exchange(list, std::memory_order_seq_cst);
+				if (old) retired.push_back(old);
+			}
+
+			auto* list = new SinkList;
+			list->slots = lists[0];
+			list->text_level = text_level;
+			for (const auto& group : groups_) {
+				list->groups.push_back(group.get());
+			}
+			retired.push_back(sinks_.exchange(list, std::memory_order_seq_cst));
+		}
+
+		// 이전 스냅샷을 읽던 워커가 모두 구간을 벗어나면 지운다 (sinks_mutex_를 놓은 뒤 호출)
+		// 워커 스레드(싱크 안)에서는 자기 자신을 기다릴 수 없으므로 다음 변경이나 소멸 때까지 미룬다.
+		void reclaim_sinks(std::vector<const SinkList*>& retired, std::vector<const detail::EpochReader*> readers) {
+			if (delivering()) {
+				std::lock_guard<std::mutex> lock(sinks_mutex_);
+				retired_sinks_.insert(retired_sinks_.end(), retired.begin(), retired.end());
+				retired.clear();
+				return;
+			}
+
+			sink_epoch_.synchronize(readers);
+			for (const SinkList* list : retired) {
+				delete list;
+			}
+			retired.clear();
+		}
+
+		// sinks_mutex_ 아래에서 호출: 회수 대기 중인 목록과 기다릴 워커들을 넘겨받는다
+		std::vector<const detail::EpochReader*> take_retired(std::vector<const SinkList*>& retired) {
+			if (!delivering()) {
+				retired.insert(retired.end(), retired_sinks_.begin(), retired_sinks_.end());
+				retired_sinks_.clear();
+			}
+
+			std::vector<const detail::EpochReader*> readers{ &worker_reader_ };
+			for (const auto& group : groups_) {
+				readers.push_back(&group->reader);
+			}
+			return readers;
+		}
+
+		bool flush_done(uint64_t ticket, const std::vector<SinkGroup*>& groups) const {
+			if (flush_completed_ < ticket) return false;
+			return std::all_of(groups.begin(), groups.end(),
+				[ticket](const SinkGroup* group) { return group->flushed_ticket >= ticket; });
+		}
+
+		void worker_loop() {
+			std::vector<LogEntry> batch;
+			batch.reserve(100);
+			delivering() = true;
+			uint64_t options_version = 0;
+
+			uint64_t flushed_ticket = 0;
+			uint64_t reopened = reopen_ticket();
+			last_profile_report_ = std::chrono::steady_clock::now();
+
+			while (running_.load(std::memory_order_acquire)) {
+				apply_worker_options(options_version);
+				bool staging = staging_enabled_.load(std::memory_order_relaxed)
+					|| has_stages_.load(std::memory_order_relaxed);
+				auto timeout = std::chrono::milliseconds(flush_tick_ms_.load(std::memory_order_relaxed));
+				if (staging) {
+					timeout = (std::min)(timeout,
+						std::chrono::milliseconds(staging_max_delay_ms_.load(std::memory_order_relaxed)));
+				}
+
+				queue_waiter_.wait([this, flushed_ticket, reopened] {
+					return !log_queue_->empty_approx()
+						|| staged_chunks_.load(std::memory_order_relaxed) != nullptr
+						|| flush_requested_.load(std::memory_order_relaxed) != flushed_ticket
+						|| reopen_requested_.load(std::memory_order_relaxed) + detail::ReopenSignal::generation() != reopened
+						|| !running_.load(std::memory_order_acquire);
+					}, timeout);
+
+				std::lock_guard<std::mutex> delivery(delivery_mutex_);
+				detail::EpochDomain::Guard pin(sink_epoch_, worker_reader_);
+				reopen_if_requested(current_sinks().slots, reopened);
+
+				uint64_t ticket = flush_requested_.load(std::memory_order_acquire);
+				if (ticket != flushed_ticket) {
+					complete_flush(batch, ticket);
+					flushed_ticket = ticket;
+					continue;
+				}
+
+				batch.clear();
+				if (drain_queue(batch, 100) > 0) {
+					dispatch_batch(batch);
+				}
+
+				if (staging) {
+					sweep_stages(false);
+				}
+				drain_staged();
+
+				report_repeats(false);
+				report_dropped(false);
+				report_profiles(false);
+				report_stats();
+				flush_sinks(false);
+			}
+
+			// 종료 시 남은 로그들 처리
+			std::lock_guard<std::mutex> delivery(delivery_mutex_);
+			detail::EpochDomain::Guard pin(sink_epoch_, worker_reader_);
+			batch.clear();
+			while (drain_queue(batch, 100) > 0) {
+				dispatch_batch(batch);
+				batch.clear();
+			}
+			sweep_stages(true, true);
+			drain_staged();
+			report_repeats(true);
+			report_dropped(true);
+			report_profiles(true);
+			try {
+				flush_sinks(true);
+			}
+			catch (...) {
+				// 종료 시에는 에러 무시
+			}
+
+			// 종료 중에 들어온 flush() 대기자도 깨운다
+			{
+				std::lock_guard<std::mutex> lock(flush_mutex_);
+				flush_completed_ = flush_requested_.load(std::memory_order_acquire);
+			}
+			flush_cv_.notify_all();
+
+			detail::StagedChunk* chunk = nullptr;
+			while (chunk_pool_->try_pop(chunk)) {
+				delete chunk;
+			}
+		}
+
+	public:
+		static Logger& get_instance() {
+			static Logger instance;
+			// LOG_PROFILE 요약은 전역 인스턴스만 기본으로 출력한다
+			static const bool profiled = [] {
+				instance.set_profile_interval(std::chrono::seconds(10));
+				return true;
+			}();
+			(void)profiled;
+			return instance;
+		}
+
+		Logger() : sinks_(new SinkList),
+			reopen_requested_(0),
+			min_level_(LogLevel::DEBUG),
+			running_(false),
+			initialized_(false),
+			max_queue_size_(10000),
+			staging_enabled_(false),
+			staging_chunk_size_(64),
+			staging_max_delay_ms_(10),
+			staged_chunks_(nullptr),
+			has_stages_(false),
+			instance_id_(next_instance_id()),
+			deferred_formatting_(false),
+			flush_requested_(0),
+			flush_completed_(0),
+			flush_tick_ms_(1000),
+			overflow_block_ms_(100),
+			overflow_sample_rate_(10),
+			overflow_sample_counter_(0),
+			reported_dropped_{},
+			space_waiters_(0),
+			batches_(0),
+			batch_entries_(0),
+			max_batch_(0),
+			profile_interval_ms_(0),
+			dedup_enabled_(false),
+			sync_level_(kSyncOff),
+			worker_options_version_(0) {
+			for (size_t i = 0; i < kLevelCount; ++i) {
+				overflow_policy_[i].store(OverflowPolicy::DropOldest, std::memory_order_relaxed);
+				dropped_[i].store(0, std::memory_order_relaxed);
+			}
+		}
+
+		~Logger() {
+			if (initialized_.load()) {
+				running_.store(false, std::memory_order_release);
+				queue_waiter_.notify_all();
+
+				if (worker_thread_.joinable()) {
+					worker_thread_.join();
+				}
+
+				// 그룹 워커는 기본 워커가 넘긴 배치를 모두 출력한 뒤 종료
+				for (auto& group : groups_) {
+					{
+						std::lock_guard<std::mutex> lock(group->mutex);
+						group->stop = true;
+					}
+					group->cv.notify_one();
+					group->thread.join();
+				}
+
+				SharedBatch* shared = nullptr;
+				while (batch_pool_->try_pop(shared)) {
+					delete shared;
+				}
+			}
+
+			for (auto& group : groups_) {
+				delete group->sinks.load(std::memory_order_relaxed);
+			}
+			delete sinks_.load(std::memory_order_relaxed);
+			for (const SinkList* list : retired_sinks_) {
+				delete list;
+			}
+		}
+
+		// 복사/이동 방지
+		Logger(const Logger&) = delete;
+		Logger& operator=(const Logger&) = delete;
+		Logger(Logger&&) = delete;
+		Logger& operator=(Logger&&) = delete;
+
+		// options.message_regex가 올바른 정규식이 아니면 std::regex_error를 던진다 (싱크는 추가되지 않음)
+		void add_sink(std::unique_ptr<LogSink> sink, SinkOptions options = {}) {
+			ensure_initialized();
+
+			// 주기 플러시가 밀리지 않도록 워커 대기 시간을 가장 짧은 주기에 맞춘다
+			auto interval = options.flush.interval.count();
+			if (interval > 0 && interval < flush_tick_ms_.load(std::memory_order_relaxed)) {
+				flush_tick_ms_.store(interval, std::memory_order_relaxed);
+			}
+
+			auto slot = std::make_shared<SinkSlot>();
+			slot->sink = std::move(sink);
+			slot->options = options;
+			slot->last_flush = std::chrono::steady_clock::now();
+			slot->counters = std::make_unique<detail::SinkCounters>();
+			if (!options.message_regex.empty()) {
+				slot->message_regex = std::make_unique<std::regex>(options.message_regex, std::regex::ECMAScript | std::regex::optimize);
+			}
+			slot->filtered = options.min_level > LogLevel::DEBUG || !options.loggers.empty()
+				|| slot->message_regex || options.filter;
+
+			std::vector<const SinkList*> retired;
+			std::vector<const detail::EpochReader*> readers;
+			{
+				std::lock_guard<std::mutex> lock(sinks_mutex_);
+				SlotLists lists = current_slot_lists();
+				SinkGroup* created = nullptr;
+
+				if (options.worker_group <= 0) {
+					lists[0].push_back(std::move(slot));
+				}
+				else {
+					auto found = std::find_if(groups_.begin(), groups_.end(),
+						[&](const std::unique_ptr<SinkGroup>& group) { return group->id == options.worker_group; });
+					if (found != groups_.end()) {
+						lists[static_cast<size_t>(found - groups_.begin()) + 1].push_back(std::move(slot));
+					}
+					else {
+						auto group = std::make_unique<SinkGroup>();
+						group->id = options.worker_group;
+						created = group.get();
+						groups_.push_back(std::move(group));
+						lists.emplace_back();
+						lists.back().push_back(std::move(slot));
+					}
+				}
+
+				publish_sinks(lists, retired);
+				if (created) {
+					created->thread = std::thread(&Logger::group_loop, this, std::ref(*created));
+				}
+				readers = take_retired(retired);
+			}
+			reclaim_sinks(retired, readers);
+		}
+
+		// 싱크 하나를 빼고 소유권을 돌려준다 (없으면 nullptr). 워커는 멈추지 않는다.
+		// 반환 시점에는 어느 워커도 이 싱크를 쓰고 있지 않으며 남은 출력은 플러시된 상태다.
+		// 워커 스레드(싱크 안)에서 호출하면 회수를 기다릴 수 없으므로 nullptr을 반환하고 싱크는 나중에 지운다.
+		std::unique_ptr<LogSink> remove_sink(const LogSink* sink) {
+			ensure_initialized();
+			std::shared_ptr<SinkSlot> removed;
+			std::vector<const SinkList*> retired;
+			std::vector<const detail::EpochReader*> readers;
+			{
+				std::lock_guard<std::mutex> lock(sinks_mutex_);
+				SlotLists lists = current_slot_lists();
+				for (auto& slots : lists) {
+					auto found = std::find_if(slots.begin(), slots.end(),
+						[sink](const std::shared_ptr<SinkSlot>& slot) { return slot->sink.get() == sink; });
+					if (found != slots.end()) {
+						removed = *found;
+						slots.erase(found);
+						break;
+					}
+				}
+				if (!removed) return nullptr;
+
+				publish_sinks(lists, retired);
+				readers = take_retired(retired);
+			}
+
+			bool owned = !delivering();
+			reclaim_sinks(retired, readers);
+			if (!owned) return nullptr;
+
+			std::vector<std::shared_ptr<SinkSlot>> slots{ removed };
+			flush_slots(slots, true);
+			std::unique_ptr<LogSink> result = std::move(removed->sink);
+			removed.reset();
+			return result;
+		}
+
+		// 모든 싱크를 제거 (그룹 워커 스레드는 유지된다). 제거된 싱크는 플러시한 뒤 지운다.
+		void clear_sinks() {
+			ensure_initialized();
+			SlotLists removed;
+			std::vector<const SinkList*> retired;
+			std::vector<const detail::EpochReader*> readers;
+			{
+				std::lock_guard<std::mutex> lock(sinks_mutex_);
+				removed = current_slot_lists();
+				publish_sinks(SlotLists(removed.size()), retired);
+				readers = take_retired(retired);
+			}
+
+			bool owned = !delivering();
+			reclaim_sinks(retired, readers);
+			if (!owned) return;
+
+			for (const auto& slots : removed) {
+				flush_slots(slots, true);
+			}
+		}
+
+		// 모든 싱크에 reopen()을 요청 (워커가 다음 루프에서 먼저 플러시하고 다시 연다, 반환을 기다리지 않음)
+		// logrotate 등이 파일을 옮긴 뒤 같은 경로로 새 파일을 열 때 사용한다.
+		void reopen_sinks() {
+			ensure_initialized();
+			reopen_requested_.fetch_add(1, std::memory_order_acq_rel);
+			queue_waiter_.notify_all();
+
+			std::lock_guard<std::mutex> lock(sinks_mutex_);
+			for (auto& group : groups_) {
+				{
+					std::lock_guard<std::mutex> group_lock(group->mutex);
+				}
+				group->cv.notify_one();
+			}
+		}
+
+#if !defined(_WIN32)
+		// signal(기본 SIGHUP)을 받으면 모든 Logger 인스턴스가 reopen_sinks()와 같이 싱크를 다시 연다
+		// 신호 처리기는 카운터만 올리고, 워커가 늦어도 플러시 주기 안에 확인해서 처리한다.
+		static void reopen_on_signal(int signal = SIGHUP) {
+			detail::ReopenSignal::install(signal);
+		}
+#endif
+
+		void set_level(LogLevel level) {
+			registry_.set_root_level(min_level_, level);
+		}
+
+		// 이름 있는 로거 핸들: 큐와 싱크를 공유하고 %n 패턴 플래그로 이름을 출력한다
+		// 이름은 점으로 계층을 나누며 레벨을 지정하지 않은 로거는 가장 가까운 상위 로거(없으면 기본 레벨)를 따른다.
+		NamedLogger get_logger(const std::string& name);
+
+		void set_level(const std::string& name, LogLevel level) {
+			registry_.configure(name, static_cast<int>(level));
+		}
+
+		// 직접 지정한 레벨을 지우고 상위 로거의 레벨을 다시 상속
+		void reset_level(const std::string& name) {
+			registry_.configure(name, -1);
+		}
+
+		// LOG_* 매크로가 인자를 평가하기 전에 호출하는 레벨 검사 (relaxed 로드 한 번)
+		// 플라이트 레코더가 켜져 있으면 레코더 레벨 이상도 통과한다.
+		bool should_log(LogLevel level) const {
+			return level >= min_level_.load(std::memory_order_relaxed) || detail::FlightRecorder::records(level);
+		}
+
+		// 이미 만든 항목을 그대로 큐에 넣는다 (레벨 검사 없음, SharedMemoryCollector 등 다른 곳에서 받은 항목용)
+		// 동기 모드와 FATAL 처리는 일반 로깅과 같다.
+		void submit(LogEntry&& entry) {
+			log_entry(std::move(entry));
+		}
+
+		// 호출 전에 기록된 로그가 모든 싱크에 쓰이고 플러시될 때까지 대기
+		// 싱크 내부(워커 스레드)에서 호출하면 교착을 피하기 위해 바로 반환한다.
+		void flush() {
+			if (!initialized_.load(std::memory_order_acquire)) return;
+			if (delivering()) return;
+
+			std::vector<SinkGroup*> groups;
+			{
+				std::lock_guard<std::mutex> lock(sinks_mutex_);
+				for (const auto& group : groups_) {
+					groups.push_back(group.get());
+				}
+			}
+
+			uint64_t ticket = flush_requested_.fetch_add(1, std::memory_order_acq_rel) + 1;
+			queue_waiter_.notify_all();
+
+			std::unique_lock<std::mutex> lock(flush_mutex_);
+			flush_cv_.wait(lock, [this, ticket, &groups] {
+				return flush_done(ticket, groups) || !running_.load(std::memory_order_acquire);
+				});
+		}
+
+		// 큐가 가득 찼을 때의 처리 방식 (모든 레벨 / 특정 레벨)
+		// 스레드별 버퍼링 모드의 청크 전달에는 적용되지 않는다.
+		void set_overflow_policy(OverflowPolicy policy) {
+			for (auto& level_policy : overflow_policy_) {
+				level_policy.store(policy, std::memory_order_relaxed);
+			}
+		}
+
+		void set_overflow_policy(LogLevel level, OverflowPolicy policy) {
+			overflow_policy_[static_cast<size_t>(level)].store(policy, std::memory_order_relaxed);
+		}
+
+		// Block 정책의 최대 대기 시간
+		void set_overflow_block_timeout(std::chrono::milliseconds timeout) {
+			overflow_block_ms_.store(timeout.count(), std::memory_order_relaxed);
+		}
+
+		// Sample 정책: 가득 찬 동안 rate개 중 하나만 넣는다
+		void set_overflow_sample_rate(uint32_t rate) {
+			overflow_sample_rate_.store((std::max)(rate, 1u), std::memory_order_relaxed);
+		}
+
+		// 큐가 가득 차서 버린 항목 수 (누적)
+		uint64_t dropped_count(LogLevel level) const {
+			return dropped_[static_cast<size_t>(level)].load(std::memory_order_relaxed);
+		}
+
+		uint64_t dropped_count() const {
+			uint64_t total = 0;
+			for (const auto& count : dropped_) {
+				total += count.load(std::memory_order_relaxed);
+			}
+			return total;
+		}
+
+		// 로거 자체 계측 스냅샷 (모든 카운터는 relaxed 원자 변수라 켜 둔 채로 운영해도 된다)
+		LoggerStats stats() {
+			LoggerStats result;
+			result.enqueued = enqueued_.load();
+			for (size_t i = 0; i < kLevelCount; ++i) {
+				result.dropped_by_level[i] = dropped_[i].load(std::memory_order_relaxed);
+				result.dropped += result.dropped_by_level[i];
+			}
+			if (initialized_.load(std::memory_order_acquire)) {
+				result.queue_depth = log_queue_->size_approx();
+				result.queue_capacity = log_queue_->capacity();
+			}
+			result.batches = batches_.load(std::memory_order_relaxed);
+			result.batch_entries = batch_entries_.load(std::memory_order_relaxed);
+			result.max_batch = max_batch_.load(std::memory_order_relaxed);
+
+			std::vector<uint64_t> counts(detail::LatencyHistogram::kBucketCount);
+			for (size_t i = 0; i < counts.size(); ++i) {
+				counts[i] = enqueue_latency_.buckets[i].load(std::memory_order_relaxed);
+				result.enqueue_samples += counts[i];
+			}
+			if (result.enqueue_samples > 0) {
+				result.enqueue_max_ns = enqueue_latency_.max.load(std::memory_order_relaxed);
+				result.enqueue_p50_ns = (std::min)(detail::histogram_percentile(counts, result.enqueue_samples, 0.50), result.enqueue_max_ns);
+				result.enqueue_p99_ns = (std::min)(detail::histogram_percentile(counts, result.enqueue_samples, 0.99), result.enqueue_max_ns);
+			}
+
+			std::lock_guard<std::mutex> lock(sinks_mutex_);
+			collect_sink_stats(sinks_.load(std::memory_order_relaxed)->slots, 0, result.sinks);
+			for (const auto& group : groups_) {
+				collect_sink_stats(group->sinks.load(std::memory_order_relaxed)->slots, group->id, result.sinks,
+					group->dropped.load(std::memory_order_relaxed));
+			}
+			return result;
+		}
+
+		// interval마다 워커 스레드에서 stats()를 넘겨 호출 (nullptr이면 끔)
+		void set_stats_callback(std::function<void(const LoggerStats&)> callback,
+			std::chrono::milliseconds interval = std::chrono::seconds(10)) {
+			{
+				std::lock_guard<std::mutex> lock(stats_mutex_);
+				stats_callback_ = std::move(callback);
+				stats_interval_ = interval;
+				last_stats_report_ = std::chrono::steady_clock::now();
+			}
+			if (interval.count() > 0 && interval.count() < flush_tick_ms_.load(std::memory_order_relaxed)) {
+				flush_tick_ms_.store(interval.count(), std::memory_order_relaxed);
+			}
+		}
+
+		// LOG_PROFILE 요약을 출력하는 주기 (get_instance()는 기본 10초, 직접 만든 인스턴스는 기본 0 = 끔)
+		// 히스토그램은 프로세스 전역이고 출력할 때 비워지므로, 켜 둔 인스턴스가 여럿이면 표본이 나뉜다.
+		void set_profile_interval(std::chrono::milliseconds interval) {
+			profile_interval_ms_.store(interval.count(), std::memory_order_relaxed);
+			if (interval.count() > 0 && interval.count() < flush_tick_ms_.load(std::memory_order_relaxed)) {
+				flush_tick_ms_.store(interval.count(), std::memory_order_relaxed);
+			}
+		}
+
+		// 플라이트 레코더: level 이상의 모든 호출을 스레드별 링(최근 entries_per_thread개)에 포맷 없이 남긴다
+		// set_level과 무관하게 기록되며, FATAL 로그와 치명적 신호(POSIX: SIGSEGV/SIGABRT/SIGBUS/SIGFPE/SIGILL)에서
+		// path 파일 끝에 시간순으로 덧붙인다. 링 크기는 이후 새로 만들어지는 링부터 적용되고, 레코더는 프로세스 전역이다.
+		void enable_flight_recorder(const std::string& path, size_t entries_per_thread = 256,
+			LogLevel level = LogLevel::DEBUG) {
+			size_t length = (std::min)(path.size(), detail::FlightRecorder::kMaxPath - 1);
+			std::memcpy(detail::FlightRecorder::path, path.data(), length);
+			detail::FlightRecorder::path[length] = '\0';
+			detail::FlightRecorder::entries_per_thread.store(entries_per_thread, std::memory_order_relaxed);
+#if !defined(_WIN32)
+			detail::CrashSignals::install();  // 기록을 켜기 전에: 이후 링을 만드는 스레드마다 대체 스택을 둔다
+#endif
+			detail::FlightRecorder::level.store(static_cast<int>(level), std::memory_order_relaxed);
+		}
+
+		// 기록만 멈춘다 (링과 신호 처리기는 남아 있어 이미 기록된 내용은 덤프할 수 있다)
+		void disable_flight_recorder() {
+			detail::FlightRecorder::level.store(detail::FlightRecorder::kDisabled, std::memory_order_relaxed);
+		}
+
+		// 지금까지의 링 내용을 파일에 덧붙인다 (다른 덤프가 진행 중이거나 파일을 열 수 없으면 false)
+		bool dump_flight_recorder(const char* reason = "manual") {
+			return detail::FlightRecorder::dump(reason);
+		}
+
+		// 워커가 연속으로 같은 메시지(레벨, 로거 이름, 텍스트가 같음)를 하나로 묶고
+		// 다른 메시지가 오거나 1초가 지나면 "last message repeated N times" 항목을 출력한다.
+		void set_deduplication(bool enabled) {
+			dedup_enabled_.store(enabled, std::memory_order_relaxed);
+		}
 
-	public:
-		explicit ConsoleSink(bool use_colors = true) : use_colors_(use_colors) {}
+		// 큐는 첫 로그(또는 add_sink) 시점에 미리 할당되므로 그 전에 호출해야 적용된다
+		void set_max_queue_size(size_t size) {
+			max_queue_size_ = size;
+		}
 
-		void write(const LogEntry& entry) override {
-			std::string color_code = use_colors_ ? get_color_code(entry.level) : "";
-			std::string reset_code = use_colors_ ? get_reset_code() : "";
+		// 지연 포맷: LOG_* 매크로(CPPLOG_FORMAT) 호출은 포맷 포인터와 인자 바이트만 기록하고, 치환은 워커가 수행한다
+		// 문자열을 직접 넘긴 호출이나 지원하지 않는 인자 타입(사용자 정의 타입 등)은 기존처럼 호출 스레드에서 포맷한다.
+		void set_deferred_formatting(bool enabled) {
+			deferred_formatting_.store(enabled, std::memory_order_relaxed);
+		}
 
-			std::cout << color_code
-				<< "[" << format_timestamp(entry.timestamp) << "] "
-				<< level_to_string(entry.level) << " "
-				<< "[" << entry.thread_id << "] "
-				<< entry.message
-				<< reset_code << std::endl;
+		// 스레드별 스테이징: 각 생산자 스레드가 청크 단위로 모아서 워커에 넘긴다
+		// 청크가 chunk_size개가 되거나 max_delay가 지나면 전달되며, 스레드 종료/로거 소멸 시 남은 로그도 출력된다.
+		void set_thread_buffering(bool enabled, size_t chunk_size = 64,
+			std::chrono::milliseconds max_delay = std::chrono::milliseconds(10)) {
+			staging_chunk_size_.store((std::max)(chunk_size, static_cast<size_t>(1)), std::memory_order_relaxed);
+			staging_max_delay_ms_.store(max_delay.count(), std::memory_order_relaxed);
+			staging_enabled_.store(enabled, std::memory_order_relaxed);
+			queue_waiter_.notify_all();
 		}
 
-		void flush() override {
-			std::cout.flush();
+		// level 이상의 로그를 큐를 거치지 않고 호출한 스레드에서 바로 포맷해서 싱크에 기록 (false면 끔)
+		// 단일 스레드 도구나 지연보다 즉시성이 중요한 경우용이며, 워커와는 락 하나로 순서를 맞춘다.
+		// FATAL은 이 설정과 관계없이 항상 동기로 기록되고 플러시된 뒤 반환한다.
+		void set_synchronous(bool enabled, LogLevel level = LogLevel::DEBUG) {
+			sync_level_.store(enabled ? static_cast<int>(level) : kSyncOff, std::memory_order_relaxed);
 		}
 
-	private:
-		inline std::string get_color_code(LogLevel level) const {
-			switch (level) {
-			case LogLevel::DEBUG: return "\033[36m";    // Cyan
-			case LogLevel::INFO:  return "\033[32m";    // Green
-			case LogLevel::WARN:  return "\033[33m";    // Yellow
-			case LogLevel::ERROR: return "\033[31m";    // Red
-			case LogLevel::FATAL: return "\033[35m";    // Magenta
-			default: return "";
+		// 워커 스레드의 CPU 고정, 우선순위, 유휴 대기 방식 (싱크 그룹 워커에는 CPU와 우선순위만 적용)
+		// 각 워커가 다음 루프(그룹 워커는 늦어도 flush 주기 안)에 자기 스레드에 적용하며, 시작 전에 호출해도 된다.
+		void set_worker_options(const WorkerOptions& options) {
+			{
+				std::lock_guard<std::mutex> lock(worker_options_mutex_);
+				worker_options_ = options;
 			}
+			worker_options_version_.fetch_add(1, std::memory_order_release);
+			queue_waiter_.set_strategy(options.idle);
 		}
 
-		inline std::string get_reset_code() const {
-			return "\033[0m";
+		// 모든 템플릿 함수들
+		template<typename Format, typename... Args>
+		void debug(Format&& format, Args&&... args) {
+			log(LogLevel::DEBUG, std::forward<Format>(format), std::forward<Args>(args)...);
 		}
-	};
 
-	class FileSink : public LogSink {
-	private:
-		std::string filename_;
-		std::ofstream file_;
-		size_t max_file_size_;
-		int max_files_;
-		size_t current_size_;
+		template<typename Format, typename... Args>
+		void info(Format&& format, Args&&... args) {
+			log(LogLevel::INFO, std::forward<Format>(format), std::forward<Args>(args)...);
+		}
 
-	public:
-		FileSink(const std::string& filename,
-			size_t max_file_size = 10 * 1024 * 1024,
-			int max_files = 5)
-			: filename_(filename), max_file_size_(max_file_size), max_files_(max_files), current_size_(0) {
+		template<typename Format, typename... Args>
+		void warn(Format&& format, Args&&... args) {
+			log(LogLevel::WARN, std::forward<Format>(format), std::forward<Args>(args)...);
+		}
 
-			// 디렉터리 생성
-			std::filesystem::path file_path(filename);
-			if (file_path.has_parent_path()) {
-				std::filesystem::create_directories(file_path.parent_path());
-			}
+		template<typename Format, typename... Args>
+		void error(Format&& format, Args&&... args) {
+			log(LogLevel::ERROR, std::forward<Format>(format), std::forward<Args>(args)...);
+		}
 
-			file_.open(filename_, std::ios::app);
-			if (file_.is_open()) {
-				// 기존 파일 크기 확인
-				file_.seekp(0, std::ios::end);
-				current_size_ = file_.tellp();
-			}
+		template<typename Format, typename... Args>
+		void fatal(Format&& format, Args&&... args) {
+			log(LogLevel::FATAL, std::forward<Format>(format), std::forward<Args>(args)...);
 		}
 
-		~FileSink() {
-			if (file_.is_open()) {
-				file_.close();
+		// 조건부 로깅
+		template<typename Format, typename... Args>
+		void log_if(bool condition, LogLevel level, Format&& format, Args&&... args) {
+			if (condition) {
+				log(level, std::forward<Format>(format), std::forward<Args>(args)...);
 			}
 		}
 
-		void write(const LogEntry& entry) override {
-			if (!file_.is_open()) return;
-
-			std::string log_line = "[" + format_timestamp(entry.timestamp) + "] "
-				+ "[" + level_to_string(entry.level) + "] "
-				+ "[" + std::to_string(std::hash<std::thread::id>{}(entry.thread_id)) + "] ";
+	private:
+		template<typename Format, typename... Args>
+		void log(LogLevel level, Format&& format, Args&&... args) {
+			if (!should_log(level)) return;
+			write_log(nullptr, level, persists(level), std::forward<Format>(format), std::forward<Args>(args)...);
+		}
 
-			log_line += entry.message + "\n";
+		// 플라이트 레코더만 받는 레벨이면 false (큐에는 넣지 않는다)
+		bool persists(LogLevel level) const {
+			return level >= min_level_.load(std::memory_order_relaxed);
+		}
 
-			file_ << log_line;
-			current_size_ += log_line.length();
+		// 레벨 검사를 마친 호출 (logger_name은 NamedLogger가 넘기는 노드 이름)
+		// 뒤쪽의 kv() 인자는 구조화 필드로 떼어 내고 나머지만 포맷 인자로 쓴다.
+		template<typename Format, typename... Args>
+		void write_log(const char* logger_name, LogLevel level, bool persist, Format&& format, Args&&... args) {
+			constexpr size_t field_count = (static_cast<size_t>(0) + ... + (detail::is_key_value_v<Args> ? 1 : 0));
+			if constexpr (field_count == 0) {
+				write_fields(logger_name, level, persist, std::tuple<>(), std::forward<Format>(format), std::forward<Args>(args)...);
+			}
+			else {
+				constexpr size_t arg_count = sizeof...(Args) - field_count;
+				static_assert(detail::fields_trail<arg_count, std::tuple<Args...>>(std::index_sequence_for<Args...>{}),
+					"kv() fields must come after the format arguments");
+				auto all = std::forward_as_tuple(std::forward<Args>(args)...);
+				split_fields(logger_name, level, persist, std::forward<Format>(format), all,
+					std::make_index_sequence<arg_count>{}, std::make_index_sequence<field_count>{});
+			}
+		}
 
-			check_and_rotate();
+		template<typename Format, typename Tuple, size_t... A, size_t... F>
+		void split_fields(const char* logger_name, LogLevel level, bool persist, Format&& format, Tuple& all,
+			std::index_sequence<A...>, std::index_sequence<F...>) {
+			constexpr size_t offset = sizeof...(A);
+			write_fields(logger_name, level, persist, std::forward_as_tuple(std::get<offset + F>(all)...),
+				std::forward<Format>(format), std::get<A>(std::move(all))...);
 		}
 
-		void flush() override {
-			if (file_.is_open()) {
-				file_.flush();
+		template<typename Fields, typename Format, typename... Args>
+		void write_fields(const char* logger_name, LogLevel level, bool persist, const Fields& fields, Format&& format, Args&&... args) {
+			if (detail::FlightRecorder::records(level)) {
+				record_flight(logger_name, level, format, args...);
+				if (level == LogLevel::FATAL) {
+					detail::FlightRecorder::dump("fatal");
+				}
 			}
-		}
+			if (!persist) return;
 
-	private:
-		inline void check_and_rotate() {
-			if (current_size_ >= max_file_size_) {
-				rotate_file();
+			if constexpr (detail::is_compiled_format<std::decay_t<Format>>::value) {
+				log_compiled(logger_name, level, fields, std::decay_t<Format>{}, std::forward<Args>(args)...);
+				return;
+			}
+			else {
+				log_runtime(logger_name, level, fields, std::forward<Format>(format), std::forward<Args>(args)...);
 			}
 		}
 
-		inline void rotate_file() {
-			if (!file_.is_open()) return;
+		// 포맷하지 않고 스레드 링에 남긴다: LOG_* 매크로 포맷은 포인터와 지연 포맷 인자 바이트,
+		// 그 밖의 포맷은 문자열 사본 (자리가 남으면 사본 뒤에 인자 바이트도 담는다)
+		template<typename Format, typename... Args>
+		static void record_flight(const char* logger_name, LogLevel level, const Format& format, const Args&... args) {
+			detail::FlightRing* ring = detail::FlightRecorder::local_ring();
+			if (!ring) return;
 
-			file_.close();
+			detail::FlightRecord& record = detail::FlightRecorder::next(*ring);
+			record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::system_clock::now().time_since_epoch()).count();
+			record.logger_name = logger_name;
+			record.level = static_cast<uint8_t>(level);
+			record.arg_types = nullptr;
+			record.size = 0;
 
-			// 기존 로그 파일들 이름 변경
-			for (int i = max_files_ - 1; i > 0; --i) {
-				std::string old_name = filename_ + "." + std::to_string(i);
-				std::string new_name = filename_ + "." + std::to_string(i + 1);
+			if constexpr (detail::is_compiled_format<Format>::value) {
+				record.format = Format::value();
+				record.kind = detail::FlightRecord::Literal;
+				if constexpr (detail::all_deferrable_v<Args...>) {
+					size_t total = (static_cast<size_t>(0) + ... + detail::deferred_size(args));
+					if (total <= detail::FlightRecord::kDataSize) {
+						unsigned char* out = record.data;
+						((out = detail::deferred_encode(out, args)), ...);
+						(void)out;
+						record.arg_types = detail::DeferredSignature<Args...>::value;
+						record.size = static_cast<uint16_t>(total);
+						record.kind = detail::FlightRecord::Packed;
+					}
+				}
+			}
+			else {
+				// char 배열은 지역 버퍼일 수 있으므로 포인터 대신 내용을 복사한다
+				std::string_view text;
+				if constexpr (std::is_array_v<Format> && std::is_same_v<std::remove_cv_t<std::remove_extent_t<Format>>, char>) {
+					text = std::string_view(format, static_cast<size_t>(std::find(format, format + std::extent_v<Format>, '\0') - format));
+				}
+				else if constexpr (std::is_convertible_v<const Format&, std::string_view>) {
+					text = std::string_view(format);
+				}
 
-				if (std::filesystem::exists(old_name)) {
-					if (i == max_files_ - 1) {
-						std::filesystem::remove(new_name);  // 오래된 파일 삭제
+				record.format = nullptr;
+				record.kind = sizeof...(Args) > 0 ? detail::FlightRecord::PartialText : detail::FlightRecord::Text;
+				if constexpr (sizeof...(Args) > 0 && detail::all_deferrable_v<Args...>) {
+					size_t total = (static_cast<size_t>(0) + ... + detail::deferred_size(args));
+					if (text.size() + 1 + total <= detail::FlightRecord::kDataSize) {
+						std::memcpy(record.data, text.data(), text.size());
+						record.data[text.size()] = '\0';
+						unsigned char* out = record.data + text.size() + 1;
+						((out = detail::deferred_encode(out, args)), ...);
+						(void)out;
+						record.arg_types = detail::DeferredSignature<Args...>::value;
+						record.size = static_cast<uint16_t>(text.size() + 1 + total);
+						record.kind = detail::FlightRecord::PackedText;
 					}
-					std::filesystem::rename(old_name, new_name);
+				}
+				if (record.kind != detail::FlightRecord::PackedText) {
+					record.size = static_cast<uint16_t>((std::min)(text.size(), detail::FlightRecord::kDataSize));
+					std::memcpy(record.data, text.data(), record.size);
 				}
 			}
+			detail::FlightRecorder::publish(*ring);
+		}
 
-			// 현재 파일을 .1로 이름 변경
-			if (std::filesystem::exists(filename_)) {
-				std::filesystem::rename(filename_, filename_ + ".1");
+		// 즉시 포맷 경로: 텍스트보다 먼저 필드를 인자 영역에 넣는다 (자리가 없으면 false)
+		template<typename Fields>
+		static bool attach_fields(LogEntry& entry, const Fields& fields) {
+			if constexpr (std::tuple_size_v<Fields> == 0) {
+				return true;
+			}
+			else {
+				size_t size = detail::fields_size(fields);
+				if (size > LogEntry::kDeferredArgsCapacity) {
+					return false;
+				}
+				detail::encode_fields(entry.message.reserve_args(size), fields);
+				entry.field_count = static_cast<uint16_t>(std::tuple_size_v<Fields>);
+				entry.field_bytes = static_cast<uint16_t>(size);
+				return true;
 			}
+		}
 
-			// 새 파일 생성
-			file_.open(filename_, std::ios::out);
-			current_size_ = 0;
+		// 인자 영역에 들어가지 않는 필드는 " key=value"로 메시지 뒤에 붙인다
+		template<typename Fields>
+		static void append_fields_text(std::ostream& os, const Fields& fields) {
+			os << std::boolalpha;
+			std::apply([&os](const auto&... field) { ((os << ' ' << field.key << '=' << field.value), ...); }, fields);
 		}
-	};
 
-	class Logger {
-	private:
-		std::vector<std::unique_ptr<LogSink>> sinks_;
-		LogLevel min_level_;
-		std::queue<LogEntry> log_queue_;
-		std::mutex queue_mutex_;
-		std::condition_variable queue_condition_;
-		std::thread worker_thread_;
-		std::atomic<bool> running_;
-		std::atomic<bool> initialized_;
-		std::once_flag init_flag_;
-		size_t max_queue_size_;
+		template<typename Fields, typename Source, typename... Args>
+		void log_compiled(const char* logger_name, LogLevel level, const Fields& fields,
+			detail::CompiledFormat<Source>, Args&&... args) {
+			using Format = detail::CompiledFormat<Source>;
+			static_assert(Format::arg_count == sizeof...(Args),
+				"LOG_* format string placeholder count does not match the number of arguments");
+
+			if constexpr (detail::all_deferrable_v<Args...>) {
+				if (deferred_formatting_.load(std::memory_order_relaxed)
+					&& log_deferred(logger_name, level, fields, Format::value(), args...)) {
+					return;
+				}
+			}
+
+			LogEntry entry;
+			entry.timestamp = std::chrono::system_clock::now();
+			entry.level = level;
+			entry.thread_id = std::this_thread::get_id();
+			entry.logger_name = logger_name;
+			bool fields_attached = attach_fields(entry, fields);
 
-		template<typename T>
-		void safe_append(std::ostringstream& oss, T&& value) {
 			try {
-				oss << std::forward<T>(value);
+				detail::MessageStream stream(entry.message);
+				format_compiled<Format>(stream.get(), std::index_sequence_for<Args...>{}, std::forward<Args>(args)...);
+				if (!fields_attached) {
+					append_fields_text(stream.get(), fields);
+				}
 			}
 			catch (...) {
-				oss << "[FORMAT_ERROR]";
+				entry.message.clear();  // 메시지 초기화
+				entry.message.append("[LOG_ERROR] ");
+				entry.message.append(Format::value());
 			}
+
+			log_entry(std::move(entry));
 		}
 
-		void format_recursive(std::ostringstream& oss, const std::string& format) {
-			oss << format;
+		// 미리 계산된 구간을 그대로 쓰므로 find/substr 없이 기록
+		template<typename Format, typename... Args, size_t... I>
+		void format_compiled(std::ostream& os, std::index_sequence<I...>, Args&&... args) {
+			const char* format = Format::value();
+			((os.write(format + Format::segment_begin(I), Format::segment_length(I)),
+				safe_append(os, std::forward<Args>(args))), ...);
+			os.write(format + Format::segment_begin(sizeof...(Args)), Format::segment_length(sizeof...(Args)));
 		}
 
-		template<typename T, typename... Args>
-		void format_recursive(std::ostringstream& oss, const std::string& format,
-			T&& value, Args&&... args) {
-			size_t pos = format.find("{}");
-			if (pos != std::string::npos) {
-				oss << format.substr(0, pos);
-				safe_append(oss, std::forward<T>(value));
-				format_recursive(oss, format.substr(pos + 2), std::forward<Args>(args)...);
+		template<typename Fields, typename Format, typename... Args>
+		void log_runtime(const char* logger_name, LogLevel level, const Fields& fields, Format&& format, Args&&... args) {
+			// const char 배열은 지역 버퍼일 수 있어 포인터를 남기지 않고 호출 시점에 포맷한다
+			if constexpr (std::is_convertible_v<Format, std::string_view>) {
+				log_formatted(logger_name, level, fields, std::string_view(format), std::forward<Args>(args)...);
 			}
 			else {
-				oss << format;
-				// 남은 인자들은 무시 (포맷 문자열에 {} 부족)
+				log_formatted(logger_name, level, fields, std::string(std::forward<Format>(format)), std::forward<Args>(args)...);
 			}
 		}
 
-		void ensure_initialized() {
-			if (!initialized_.load(std::memory_order_acquire)) {
-				std::call_once(init_flag_, [this] {
-					running_ = true;
-					worker_thread_ = std::thread(&Logger::worker_loop, this);
-					initialized_.store(true, std::memory_order_release);
-					});
+		template<typename Fields, typename... Args>
+		bool log_deferred(const char* logger_name, LogLevel level, const Fields& fields, const char* format, const Args&... args) {
+			size_t total = (static_cast<size_t>(0) + ... + detail::deferred_size(args));
+			size_t field_bytes = 0;
+			if constexpr (std::tuple_size_v<Fields> > 0) {
+				field_bytes = detail::fields_size(fields);
+			}
+			if (total + field_bytes > LogEntry::kDeferredArgsCapacity) {
+				return false;
 			}
-		}
-
-		void log_entry(LogEntry&& entry) {
-			ensure_initialized();
-
-			{
-				std::lock_guard<std::mutex> lock(queue_mutex_);
 
-				// 큐가 가득 찬 경우 오래된 로그 드롭
-				if (log_queue_.size() >= max_queue_size_) {
-					log_queue_.pop();
-				}
+			LogEntry entry;
+			entry.timestamp = std::chrono::system_clock::now();
+			entry.level = level;
+			entry.thread_id = std::this_thread::get_id();
+			entry.logger_name = logger_name;
+			entry.format = format;
+			entry.arg_types = detail::DeferredSignature<Args...>::value;
 
-				log_queue_.emplace(std::move(entry));
+			unsigned char* out = entry.message.reserve_args(total + field_bytes);
+			((out = detail::deferred_encode(out, args)), ...);
+			if constexpr (std::tuple_size_v<Fields> > 0) {
+				detail::encode_fields(out, fields);
+				entry.field_count = static_cast<uint16_t>(std::tuple_size_v<Fields>);
+				entry.field_bytes = static_cast<uint16_t>(field_bytes);
 			}
-			queue_condition_.notify_one();
-		}
+			(void)out;
 
-		void worker_loop() {
-			while (running_.load()) {
-				std::unique_lock<std::mutex> lock(queue_mutex_);
+			log_entry(std::move(entry));
+			return true;
+		}
 
-				queue_condition_.wait(lock, [this] {
-					return !log_queue_.empty() || !running_.load();
-					});
+		template<typename Fields, typename... Args>
+		void log_formatted(const char* logger_name, LogLevel level, const Fields& fields, std::string_view format, Args&&... args) {
+			LogEntry entry;
+			entry.timestamp = std::chrono::system_clock::now();
+			entry.level = level;
+			entry.thread_id = std::this_thread::get_id();
+			entry.logger_name = logger_name;
+			bool fields_attached = attach_fields(entry, fields);
 
-				std::vector<LogEntry> batch;
-				while (!log_queue_.empty() && batch.size() < 100) {
-					batch.emplace_back(std::move(log_queue_.front()));
-					log_queue_.pop();
+			try {
+				detail::MessageStream stream(entry.message);
+				if constexpr (sizeof...(args) > 0) {
+					format_recursive(stream.get(), format, std::forward<Args>(args)...);
 				}
-
-				lock.unlock();
-
-				// 배치 처리된 로그들을 모든 싱크에 출력
-				for (const auto& entry : batch) {
-					for (auto& sink : sinks_) {
-						try {
-							sink->write(entry);
-						}
-						catch (const std::exception& e) {
-							// 싱크 오류는 무시하고 계속 진행
-							std::cerr << "Logger sink error: " << e.what() << std::endl;
-						}
-					}
+				else {
+					format_recursive(stream.get(), format);
 				}
-
-				// 모든 싱크 플러시
-				for (auto& sink : sinks_) {
-					try {
-						sink->flush();
-					}
-					catch (const std::exception& e) {
-						std::cerr << "Logger sink flush error: " << e.what() << std::endl;
-					}
+				if (!fields_attached) {
+					append_fields_text(stream.get(), fields);
 				}
 			}
-
-			// 종료 시 남은 로그들 처리
-			std::lock_guard<std::mutex> lock(queue_mutex_);
-			while (!log_queue_.empty()) {
-				const auto& entry = log_queue_.front();
-				for (auto& sink : sinks_) {
-					try {
-						sink->write(entry);
-						sink->flush();
-					}
-					catch (...) {
-						// 종료 시에는 에러 무시
-					}
-				}
-				log_queue_.pop();
+			catch (...) {
+				entry.message.clear();  // 메시지 초기화
+				entry.message.append("[LOG_ERROR] ");
+				entry.message.append(format);
 			}
-		}
 
-	public:
-		static Logger& get_instance() {
-			static Logger instance;
-			return instance;
+			log_entry(std::move(entry));
 		}
+	};
 
-		Logger() : min_level_(LogLevel::DEBUG),
-			running_(false),
-			initialized_(false),
-			max_queue_size_(10000) {
+	// 이름 있는 로거 핸들 (Logger::get_logger, 복사해서 보관 가능)
+	// 레벨 검사는 노드에 캐시된 유효 레벨을 한 번 읽는 것뿐이며, 레벨 변경은 레지스트리가 노드에 밀어 넣는다.
+	class NamedLogger {
+	private:
+		Logger* logger_;
+		detail::LoggerNode* node_;
+
+		template<typename Format, typename... Args>
+		void log(LogLevel level, Format&& format, Args&&... args) {
+			if (!should_log(level)) return;
+			logger_->write_log(node_->name.c_str(), level, level >= node_->effective.load(std::memory_order_relaxed),
+				std::forward<Format>(format), std::forward<Args>(args)...);
 		}
 
-		~Logger() {
-			if (initialized_.load()) {
-				running_.store(false);
-				queue_condition_.notify_all();
+	public:
+		NamedLogger(Logger& logger, detail::LoggerNode* node) : logger_(&logger), node_(node) {}
 
-				if (worker_thread_.joinable()) {
-					worker_thread_.join();
-				}
-			}
+		const std::string& name() const {
+			return node_->name;
 		}
 
-		// 복사/이동 방지
-		Logger(const Logger&) = delete;
-		Logger& operator=(const Logger&) = delete;
-		Logger(Logger&&) = delete;
-		Logger& operator=(Logger&&) = delete;
-
-		void add_sink(std::unique_ptr<LogSink> sink) {
-			ensure_initialized();
-			sinks_.push_back(std::move(sink));
+		LogLevel level() const {
+			return node_->effective.load(std::memory_order_relaxed);
 		}
 
-		void clear_sinks() {
-			ensure_initialized();
-			sinks_.clear();
+		bool should_log(LogLevel level) const {
+			return level >= node_->effective.load(std::memory_order_relaxed) || detail::FlightRecorder::records(level);
 		}
 
+		// 이 로거와 레벨을 지정하지 않은 하위 로거에 적용
 		void set_level(LogLevel level) {
-			min_level_ = level;
+			logger_->set_level(node_->name, level);
 		}
 
-		void set_max_queue_size(size_t size) {
-			max_queue_size_ = size;
+		void reset_level() {
+			logger_->reset_level(node_->name);
 		}
 
-		// 모든 템플릿 함수들
-		template<typename... Args>
-		void debug(const std::string& format, Args&&... args) {
-			log(LogLevel::DEBUG, format, std::forward<Args>(args)...);
+		template<typename Format, typename... Args>
+		void debug(Format&& format, Args&&... args) {
+			log(LogLevel::DEBUG, std::forward<Format>(format), std::forward<Args>(args)...);
 		}
 
-		template<typename... Args>
-		void info(const std::string& format, Args&&... args) {
-			log(LogLevel::INFO, format, std::forward<Args>(args)...);
+		template<typename Format, typename... Args>
+		void info(Format&& format, Args&&... args) {
+			log(LogLevel::INFO, std::forward<Format>(format), std::forward<Args>(args)...);
 		}
 
-		template<typename... Args>
-		void warn(const std::string& format, Args&&... args) {
-			log(LogLevel::WARN, format, std::forward<Args>(args)...);
+		template<typename Format, typename... Args>
+		void warn(Format&& format, Args&&... args) {
+			log(LogLevel::WARN, std::forward<Format>(format), std::forward<Args>(args)...);
 		}
 
-		template<typename... Args>
-		void error(const std::string& format, Args&&... args) {
-			log(LogLevel::ERROR, format, std::forward<Args>(args)...);
+		template<typename Format, typename... Args>
+		void error(Format&& format, Args&&... args) {
+			log(LogLevel::ERROR, std::forward<Format>(format), std::forward<Args>(args)...);
 		}
 
-		template<typename... Args>
-		void fatal(const std::string& format, Args&&... args) {
-			log(LogLevel::FATAL, format, std::forward<Args>(args)...);
+		template<typename Format, typename... Args>
+		void fatal(Format&& format, Args&&... args) {
+			log(LogLevel::FATAL, std::forward<Format>(format), std::forward<Args>(args)...);
 		}
 
-		// 조건부 로깅
-		template<typename... Args>
-		void log_if(bool condition, LogLevel level, const std::string& format, Args&&... args) {
+		template<typename Format, typename... Args>
+		void log_if(bool condition, LogLevel level, Format&& format, Args&&... args) {
 			if (condition) {
-				log(level, format, std::forward<Args>(args)...);
+				log(level, std::forward<Format>(format), std::forward<Args>(args)...);
 			}
 		}
+	};
 
+	inline NamedLogger Logger::get_logger(const std::string& name) {
+		return NamedLogger(*this, registry_.get(name));
+	}
+
+	// 기본 Logger 인스턴스의 이름 있는 로거
+	inline NamedLogger get_logger(const std::string& name) {
+		return Logger::get_instance().get_logger(name);
+	}
+
+#if !defined(_WIN32)
+	// 공유 메모리 링의 수집기 (POSIX 전용): 여러 프로세스의 SharedMemorySink가 보낸 항목을 꺼내 logger의 싱크로 보낸다
+	// 호스트당 수집기 하나가 파일과 로테이션을 맡는다. 살아 있는 다른 수집기가 이미 붙어 있으면 생성자가 예외를 던진다.
+	// 보낸 프로세스의 pid와 스레드는 구조화 필드 pid / thread로 붙는다 (자리가 없으면 생략). %t는 수집기 스레드다.
+	class SharedMemoryCollector {
 	private:
-		template<typename... Args>
-		void log(LogLevel level, const std::string& format, Args&&... args) {
-			if (level < min_level_) return;
+		detail::SharedRing ring_;
+		int32_t pid_;
+		Logger* names_owner_ = nullptr;
+		std::unordered_map<std::string, const char*> names_;  // 보낸 로거 이름 → names_owner_의 로거 이름
 
-			std::ostringstream oss;
-			try {
-				if constexpr (sizeof...(args) > 0) {
-					format_recursive(oss, format, std::forward<Args>(args)...);
+		// NamedLogger::name()은 Logger가 살아 있는 동안 같은 문자열이므로 포인터를 항목에 그대로 담는다
+		const char* logger_name(Logger& logger, std::string_view name) {
+			if (name.empty()) return nullptr;
+			if (names_owner_ != &logger) {
+				names_.clear();
+				names_owner_ = &logger;
+			}
+			std::string key(name);
+			auto it = names_.find(key);
+			if (it == names_.end()) {
+				it = names_.emplace(key, logger.get_logger(key).name().c_str()).first;
+			}
+			return it->second;
+		}
+
+		void decode(Logger& logger, const char* data, size_t size) {
+			detail::SharedRecord record;
+			if (size < sizeof(record)) return;
+			std::memcpy(&record, data, sizeof(record));
+			size_t length = sizeof(record) + record.thread_size + record.name_size + record.field_bytes;
+			if (size < length || size - length < record.message_size) return;
+
+			const char* cursor = data + sizeof(record);
+			std::string_view thread(cursor, record.thread_size);
+			cursor += record.thread_size;
+			std::string_view name(cursor, record.name_size);
+			cursor += record.name_size;
+			const char* fields = cursor;
+			cursor += record.field_bytes;
+
+			LogEntry entry;
+			entry.timestamp = std::chrono::system_clock::time_point(
+				std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(record.timestamp_ns)));
+			entry.level = static_cast<LogLevel>((std::min)(record.level, static_cast<uint8_t>(LogLevel::FATAL)));
+			entry.thread_id = std::this_thread::get_id();
+			entry.logger_name = logger_name(logger, name);
+
+			uint64_t sender = record.pid;
+			auto pid = kv("pid", sender);
+			auto thread_field = kv("thread", thread);
+			size_t origin = detail::field_size(pid) + detail::field_size(thread_field);
+			bool keep = record.field_bytes <= LogEntry::kDeferredArgsCapacity;
+			size_t field_bytes = keep ? record.field_bytes : 0;
+			size_t field_count = keep ? record.field_count : 0;
+			bool with_origin = field_bytes + origin <= LogEntry::kDeferredArgsCapacity;
+			size_t total = field_bytes + (with_origin ? origin : 0);
+			if (total > 0) {
+				unsigned char* out = entry.message.reserve_args(total);
+				std::memcpy(out, fields, field_bytes);
+				out += field_bytes;
+				if (with_origin) {
+					out = detail::encode_field(out, pid);
+					detail::encode_field(out, thread_field);
+					field_count += 2;
 				}
-				else {
-					oss << format;
+				entry.field_count = static_cast<uint16_t>(field_count);
+				entry.field_bytes = static_cast<uint16_t>(total);
+			}
+			entry.message.append(std::string_view(cursor, record.message_size));
+			logger.submit(std::move(entry));
+		}
+
+	public:
+		// 링이 없으면 만든다 (크기는 SharedMemorySink와 같은 규칙). 열지 못하면 std::runtime_error
+		explicit SharedMemoryCollector(const std::string& name,
+			size_t slot_size = SharedMemorySink::kDefaultSlotSize,
+			size_t slot_count = SharedMemorySink::kDefaultSlotCount)
+			: pid_(static_cast<int32_t>(::getpid())) {
+			std::string error;
+			if (!ring_.open(name, slot_size, slot_count, error)) {
+				throw std::runtime_error("SharedMemoryCollector: " + error);
+			}
+
+			// 이전 수집기가 살아 있으면 거절하고, 죽었으면 그 자리를 이어받는다
+			auto& owner = ring_.header().collector_pid;
+			int32_t current = owner.load(std::memory_order_acquire);
+			for (;;) {
+				if (current != 0 && current != pid_ && (::kill(current, 0) == 0 || errno != ESRCH)) {
+					throw std::runtime_error("SharedMemoryCollector: " + name + " already has a collector (pid "
+						+ std::to_string(current) + ")");
 				}
+				if (owner.compare_exchange_weak(current, pid_, std::memory_order_acq_rel)) break;
 			}
-			catch (...) {
-				oss.str("");  // 스트림 초기화
-				oss << "[LOG_ERROR] " << format;
+		}
+
+		~SharedMemoryCollector() {
+			int32_t expected = pid_;
+			ring_.header().collector_pid.compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+		}
+
+		SharedMemoryCollector(const SharedMemoryCollector&) = delete;
+		SharedMemoryCollector& operator=(const SharedMemoryCollector&) = delete;
+
+		// 모인 항목을 최대 max개까지 logger로 보내고 그 개수를 반환 (0이면 링이 비어 있다)
+		// 항목은 레벨 검사 없이 logger의 큐로 들어가고, 보낸 프로세스 순서가 아닌 링 순서를 따른다.
+		size_t poll(Logger& logger, size_t max = 1024) {
+			size_t count = 0;
+			while (count < max && ring_.pop([&](const char* data, size_t size) { decode(logger, data, size); })) {
+				++count;
 			}
+			return count;
+		}
 
-			LogEntry entry{
-				std::chrono::system_clock::now(),
-				level,
-				std::this_thread::get_id(),
-				oss.str()
-			};
+		uint64_t backlog() const {
+			return ring_.backlog();
+		}
 
-			log_entry(std::move(entry));
+		// 링 전체 카운터 (모든 생산자 합계, 링이 있는 동안 누적)
+		uint64_t dropped() const {
+			return ring_.header().dropped.load(std::memory_order_relaxed);
+		}
+
+		uint64_t truncated() const {
+			return ring_.header().truncated.load(std::memory_order_relaxed);
+		}
+
+		uint64_t abandoned() const {
+			return ring_.header().abandoned.load(std::memory_order_relaxed);
+		}
+
+		// 기록 중인 생산자가 살아 있어서 1초 넘게 기다린 슬롯 (그동안 뒤의 항목은 링에 쌓인다)
+		uint64_t stalled() const {
+			return ring_.header().stalled.load(std::memory_order_relaxed);
+		}
+
+		// 공유 메모리 이름을 지운다 (이미 붙어 있는 프로세스는 계속 쓰고, 이후 open은 새 링을 만든다)
+		static bool remove(const std::string& name) {
+			return detail::SharedRing::unlink(name);
 		}
 	};
+#endif
 
 	// RAII 스코프 로깅
 	class ScopeLogger {
@@ -482,20 +6878,150 @@ namespace utils {
 		}
 	};
 
-	// 편의 매크로들
-#define LOG_DEBUG(...) utils::Logger::get_instance().debug(__VA_ARGS__)
-#define LOG_INFO(...)  utils::Logger::get_instance().info(__VA_ARGS__)
-#define LOG_WARN(...)  utils::Logger::get_instance().warn(__VA_ARGS__)
-#define LOG_ERROR(...) utils::Logger::get_instance().error(__VA_ARGS__)
-#define LOG_FATAL(...) utils::Logger::get_instance().fatal(__VA_ARGS__)
+	namespace detail {
+
+		// LOG_EVERY_N / LOG_EVERY_MS / LOG_FIRST_N 호출 위치마다 하나씩 생기는 정적 상태
+		// 레벨이 켜져 있을 때만 센다.
+		struct RateLimitSite {
+			std::atomic<uint64_t> count{ 0 };
+			std::atomic<int64_t> next_ns{ 0 };
+
+			// 1번째, n+1번째, 2n+1번째 ... 호출만 통과
+			bool every_n(uint64_t n) {
+				return count.fetch_add(1, std::memory_order_relaxed) % (n ? n : 1) == 0;
+			}
+
+			// 처음 n번만 통과 (이후에는 카운터를 더 올리지 않는다)
+			bool first_n(uint64_t n) {
+				return count.load(std::memory_order_relaxed) < n
+					&& count.fetch_add(1, std::memory_order_relaxed) < n;
+			}
+
+			// 마지막으로 통과한 뒤 ms 이상 지났을 때만 통과 (동시에 온 호출 중 하나만)
+			bool every_ms(int64_t ms) {
+				int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now().time_since_epoch()).count();
+				int64_t next = next_ns.load(std::memory_order_relaxed);
+				return now >= next
+					&& next_ns.compare_exchange_strong(next, now + ms * 1000000, std::memory_order_relaxed);
+			}
+		};
+
+	} // namespace detail
+
+	// 문자열 리터럴을 컴파일 타임에 파싱된 포맷 타입으로 감싼다
+#define CPPLOG_FORMAT(format) \
+    [] { \
+        struct CppLogFormatSource { static constexpr const char* value() { return format; } }; \
+        return utils::detail::CompiledFormat<CppLogFormatSource>{}; \
+    }()
+
+	// 컴파일 타임 레벨: CPPLOG_ACTIVE_LEVEL보다 낮은 LOG_* 매크로는 인자 평가를 포함해 통째로 제거된다
+	// (예: -DCPPLOG_ACTIVE_LEVEL=CPPLOG_LEVEL_INFO 이면 LOG_DEBUG와 LOG_SCOPE_DEBUG가 사라진다)
+#define CPPLOG_LEVEL_DEBUG 0
+#define CPPLOG_LEVEL_INFO  1
+#define CPPLOG_LEVEL_WARN  2
+#define CPPLOG_LEVEL_ERROR 3
+#define CPPLOG_LEVEL_FATAL 4
+#define CPPLOG_LEVEL_OFF   5
+
+#ifndef CPPLOG_ACTIVE_LEVEL
+#define CPPLOG_ACTIVE_LEVEL CPPLOG_LEVEL_DEBUG
+#endif
+
+	// 런타임 레벨은 인자를 평가하기 전에 검사하므로 꺼진 레벨의 비용은 분기 하나다
+	// target은 Logger 또는 NamedLogger (여러 번 평가되므로 부수 효과가 없는 식이어야 한다)
+#define CPPLOG_LOG_TO(target, level, method, format, ...) \
+    (!(target).should_log(level) ? (void)0 : (target).method(CPPLOG_FORMAT(format), ##__VA_ARGS__))
+
+#define CPPLOG_LOG(level, method, format, ...) \
+    CPPLOG_LOG_TO(utils::Logger::get_instance(), level, method, format, ##__VA_ARGS__)
+
+	// 편의 매크로들 (포맷은 문자열 리터럴이어야 하며 {} 개수가 인자 개수와 다르면 컴파일 오류)
+	// LOG_*_TO(logger, ...)는 NamedLogger 핸들로 기록한다.
+#if CPPLOG_ACTIVE_LEVEL <= CPPLOG_LEVEL_DEBUG
+#define LOG_DEBUG(format, ...) CPPLOG_LOG(utils::LogLevel::DEBUG, debug, format, ##__VA_ARGS__)
+#define LOG_DEBUG_TO(logger, format, ...) CPPLOG_LOG_TO(logger, utils::LogLevel::DEBUG, debug, format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...) ((void)0)
+#define LOG_DEBUG_TO(logger, format, ...) ((void)0)
+#endif
+
+#if CPPLOG_ACTIVE_LEVEL <= CPPLOG_LEVEL_INFO
+#define LOG_INFO(format, ...)  CPPLOG_LOG(utils::LogLevel::INFO, info, format, ##__VA_ARGS__)
+#define LOG_INFO_TO(logger, format, ...)  CPPLOG_LOG_TO(logger, utils::LogLevel::INFO, info, format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...)  ((void)0)
+#define LOG_INFO_TO(logger, format, ...)  ((void)0)
+#endif
+
+#if CPPLOG_ACTIVE_LEVEL <= CPPLOG_LEVEL_WARN
+#define LOG_WARN(format, ...)  CPPLOG_LOG(utils::LogLevel::WARN, warn, format, ##__VA_ARGS__)
+#define LOG_WARN_TO(logger, format, ...)  CPPLOG_LOG_TO(logger, utils::LogLevel::WARN, warn, format, ##__VA_ARGS__)
+#else
+#define LOG_WARN(format, ...)  ((void)0)
+#define LOG_WARN_TO(logger, format, ...)  ((void)0)
+#endif
+
+#if CPPLOG_ACTIVE_LEVEL <= CPPLOG_LEVEL_ERROR
+#define LOG_ERROR(format, ...) CPPLOG_LOG(utils::LogLevel::ERROR, error, format, ##__VA_ARGS__)
+#define LOG_ERROR_TO(logger, format, ...) CPPLOG_LOG_TO(logger, utils::LogLevel::ERROR, error, format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...) ((void)0)
+#define LOG_ERROR_TO(logger, format, ...) ((void)0)
+#endif
+
+#if CPPLOG_ACTIVE_LEVEL <= CPPLOG_LEVEL_FATAL
+#define LOG_FATAL(format, ...) CPPLOG_LOG(utils::LogLevel::FATAL, fatal, format, ##__VA_ARGS__)
+#define LOG_FATAL_TO(logger, format, ...) CPPLOG_LOG_TO(logger, utils::LogLevel::FATAL, fatal, format, ##__VA_ARGS__)
+#else
+#define LOG_FATAL(format, ...) ((void)0)
+#define LOG_FATAL_TO(logger, format, ...) ((void)0)
+#endif
+
+// 조건부 로깅 매크로 (레벨이 꺼져 있으면 조건과 인자 모두 평가하지 않는다)
+#define LOG_IF(condition, level, format, ...) \
+    ((static_cast<int>(utils::LogLevel::level) < CPPLOG_ACTIVE_LEVEL \
+        || !utils::Logger::get_instance().should_log(utils::LogLevel::level) || !(condition)) ? (void)0 \
+        : utils::Logger::get_instance().log_if(true, utils::LogLevel::level, CPPLOG_FORMAT(format), ##__VA_ARGS__))
+
+// 호출 위치별 빈도 제한 매크로 (level은 LOG_IF처럼 DEBUG, INFO ... 로 지정)
+// 위치마다 람다 안의 정적 RateLimitSite를 하나씩 가지며, 걸러진 호출은 인자를 평가하지 않는다.
+#define CPPLOG_LOG_SITE(level, gate, format, ...) \
+    ((static_cast<int>(utils::LogLevel::level) < CPPLOG_ACTIVE_LEVEL \
+        || !utils::Logger::get_instance().should_log(utils::LogLevel::level) \
+        || !([]() -> utils::detail::RateLimitSite& { static utils::detail::RateLimitSite site; return site; }().gate)) ? (void)0 \
+        : utils::Logger::get_instance().log_if(true, utils::LogLevel::level, CPPLOG_FORMAT(format), ##__VA_ARGS__))
 
-// 조건부 로깅 매크로
-#define LOG_IF(condition, level, ...) \
-    utils::Logger::get_instance().log_if(condition, utils::LogLevel::level, __VA_ARGS__)
+#define LOG_EVERY_N(level, n, format, ...)   CPPLOG_LOG_SITE(level, every_n(n), format, ##__VA_ARGS__)
+#define LOG_FIRST_N(level, n, format, ...)   CPPLOG_LOG_SITE(level, first_n(n), format, ##__VA_ARGS__)
+#define LOG_EVERY_MS(level, ms, format, ...) CPPLOG_LOG_SITE(level, every_ms(ms), format, ##__VA_ARGS__)
 
 // 스코프 로깅 매크로
+#if CPPLOG_ACTIVE_LEVEL <= CPPLOG_LEVEL_DEBUG
 #define LOG_SCOPE(name) utils::ScopeLogger _scope_logger_(name)
 #define LOG_SCOPE_DEBUG(name) utils::ScopeLogger _scope_logger_(name, utils::LogLevel::DEBUG)
+#else
+#define LOG_SCOPE(name) ((void)0)
+#define LOG_SCOPE_DEBUG(name) ((void)0)
+#endif
+
+#if CPPLOG_ACTIVE_LEVEL <= CPPLOG_LEVEL_INFO
 #define LOG_SCOPE_INFO(name) utils::ScopeLogger _scope_logger_(name, utils::LogLevel::INFO)
+#else
+#define LOG_SCOPE_INFO(name) ((void)0)
+#endif
+
+// 프로파일 스코프: name은 문자열 리터럴이며 구간 시간만 기록하고 요약은 INFO로 출력된다
+#if CPPLOG_ACTIVE_LEVEL <= CPPLOG_LEVEL_INFO
+#define LOG_PROFILE(name) \
+    utils::ProfileScope _profile_scope_([]() -> utils::detail::LatencyHistogram& { \
+        static const utils::detail::ProfileSite site{ name }; \
+        thread_local utils::detail::ThreadHistogram histogram(site); \
+        return *histogram.histogram; \
+    }())
+#else
+#define LOG_PROFILE(name) ((void)0)
+#endif
 
 } // namespace utils